@@ -8,13 +8,13 @@
 
 #include <asf.h>
 #include "app_adc.h"
+#include "app_timers.h"
 #include "conf_adc.h"
 #include "config.h"
 #include "slpTimer.h"
 
 // ****************************************************************************
 //		Prototypes
-static void adcCheckTimerHandler(SLP_Timer_t *timer);
 void adc_complete_callback(struct adc_module *const module);
 
 // ****************************************************************************
@@ -24,11 +24,10 @@ uint8_t currentChannel         = 0;
 app_adc_callback_t adcCallback = NULL;
 bool adcBusy                   = false;
 struct adc_module adc_instance;
-static SLP_Timer_t adcCheckTimer;
 
 // ****************************************************************************
 //		ADC Check Timer
-static void adcCheckTimerHandler(SLP_Timer_t *timer)
+void adcCheckTimerHandler(SLP_Timer_t *timer)
 {
     UNUSED(timer);
 
@@ -47,7 +46,7 @@ static void adcCheckTimerHandler(SLP_Timer_t *timer)
 //		ADC Sample Complete Callback
 void adc_complete_callback(struct adc_module *const module)
 {
-    SLP_TimerStop(&adcCheckTimer);
+    SLP_TimerStop(APP_TIMER(ADC_CHECK));
 
     uint32_t averageADCvalue = 0;
 
@@ -139,10 +138,7 @@ enum status_code app_adc_configure(uint8_t ADC_channel, app_adc_callback_t callb
     adc_enable_callback(&adc_instance, ADC_CALLBACK_READ_BUFFER);
     adc_read_buffer_job(&adc_instance, adc_result_buffer, CONF_ADC_NUM_SAMPLES);
 
-    adcCheckTimer.interval = CONF_ADC_CHK_TMR_INTERVAL;
-    adcCheckTimer.mode     = SLP_TIMER_INTERVAL_MODE;
-    adcCheckTimer.handler  = adcCheckTimerHandler;
-    SLP_TimerRestart(&adcCheckTimer);
+    SLP_TimerRestart(APP_TIMER(ADC_CHECK));
 
     return STATUS_OK;
 }
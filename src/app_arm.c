@@ -15,41 +15,186 @@
  */
 
 #include <asf.h>
+#include <stddef.h>
+#include <string.h>
 #include "app_arm.h"
 #include "app_LED.h"
 #include "app_buzzer.h"
 #include "app_eeprom.h"
 #include "app_gen_io.h"
+#include "app_timers.h"
 #include "app_uart.h"
 //#include "app_user_options.h"
 #include "sysTimer.h"
 
 #define AUTO_ARM_TIME              60000    // 1 minute non-boot auto arm
 #define DEFAULT_MODE_AUTO_ARM_TIME 900000   // 15 min on boot
-#define ALARM_TIME_BEFORE_SILENT   300000   // Limit changed from 10 min -> 5 min 8/25/2020
 #define DISARM_DURATION            1000
-#define DISARM_FLASH_TIME          1000     // Milli-seconds till pulse
+#define AUTO_ARM_SLACK             1000     // Milli-seconds auto arm may be late
 
 // #define ENABLE_ARM_DEBUG_MSGS 1 // Uncomment to print out Debug messages
 
 ////////////////////////////////////////////////////////////////
 // Local variables
-static SYS_Timer_t appAutoArmTimer;
-static SYS_Timer_t app_arm_alarm_LimitTimer;
 static SYS_Timer_t appDisarmDurationTimer;
-static SYS_Timer_t appDisarmFlashTimer;
 static bool keyArmInBBU;
-static AlarmStatus_t armAlarmStatus;
+
+// One arm domain. The timers come first so a handler can find its zone from the timer.
+typedef struct ArmZone_t
+{
+    SYS_Timer_t autoArmTimer;
+    SYS_Timer_t alarmLimitTimer;
+    uint16_t    channels;                   // Channels in this zone, bit n = channel n
+    uint8_t     state;                      // enum arm_state
+} ArmZone_t;
+
+#define ARM_ZONE_OF(timer, member)  ((ArmZone_t *)((uint8_t *)(timer) - offsetof(ArmZone_t, member)))
+
+static ArmZone_t armZones[ARM_ZONE_COUNT];
+static uint8_t channelZone[CH_COUNT];
+
+// Zone bitmaps, bit z = zone z, kept by armDispatch()
+static uint8_t zonesArmed;                  // Armed by ARM/AUTO_ARM until disarmed
+static uint8_t zonesAlarming;
+static uint8_t zonesSilent;
+static uint8_t zonesChannelAlarm;           // Alarmed by one of its channels
+static bool tamperAlarming;                 // Tamper siren with no zone armed, ARM_TAMPER_LIMIT running
+
+// Auto-arm only looks at channels that changed since it last ran. Candidates carry
+// over while power or nDISARM don't allow arming.
+static uint16_t autoArmCandidates;
+static uint32_t autoArmEvaluations;             // Zone passes that checked power/nDISARM and armed ports
+static uint32_t autoArmSkips;                   // Passes with nothing changed
+
+// Module arm/alarm state, one aligned byte per flag. Packed by app_arm_get_alarm_status().
+// armed, silentAlarm and channel_Alarm summarize the zones.
+typedef struct ArmState_t
+{
+    uint8_t armed;
+    uint8_t silentAlarm;
+    uint8_t channel_Alarm;                  // ANY Channel can cause this, WHICH alarmed is in the channel alarming mask
+    uint8_t powerTamper_Armed;
+    uint8_t powerTamper_Alarm;
+    uint8_t daisyChainTamper_Alarm;
+    uint8_t daisyChainTamper_Armed;
+} ArmState_t;
+
+static ArmState_t armAlarmStatus;
 volatile uint16_t disarmDuration;
 
-extern volatile PortStatus_t portStatus[CH_COUNT];
+// Module not-ready reasons, ARM_NOT_READY_*. Cable reasons come from the present mask.
+static volatile uint8_t armNotReady = ARM_NOT_READY_BOOTING | ARM_NOT_READY_NO_DAISY_CHAIN;
+
+// Transition actions on the dispatched zone, run in bit order after the zone has
+// taken its next state. Alarming/silent follow from the state, armed is its own flag
+// set and cleared by ARM_ACT_SET_ARMED/ARM_ACT_CLEAR_ARMED ahead of the others.
+enum
+{
+    ARM_ACT_CLEAR_ALARMS        = 1 << 0,  // Channel and daisy chain causes
+    ARM_ACT_CLEAR_POWER_ALARM   = 1 << 1,
+    ARM_ACT_DISARM_PORTS        = 1 << 2,
+    ARM_ACT_AUTO_ARM_TIMER      = 1 << 3,  // Restart the zone auto-arm timer
+    ARM_ACT_STOP_DURATION       = 1 << 4,  // Stop the disarm duration timer
+    ARM_ACT_SIREN_ON            = 1 << 5,  // Buzzer and zone alarm time limit
+    ARM_ACT_SIREN_OFF           = 1 << 6,
+    ARM_ACT_DISARM_FLASH        = 1 << 7,
+    ARM_ACT_LED                 = 1 << 8,
+    ARM_ACT_SET_ARMED           = 1 << 9,
+    ARM_ACT_CLEAR_ARMED         = 1 << 10,
+};
+
+#define ARM_ACTS_ARM        (ARM_ACT_SET_ARMED | ARM_ACT_CLEAR_ALARMS | ARM_ACT_STOP_DURATION | ARM_ACT_LED)
+#define ARM_ACTS_DISARM     (ARM_ACT_CLEAR_ARMED | ARM_ACT_CLEAR_ALARMS | ARM_ACT_CLEAR_POWER_ALARM |\
+                             ARM_ACT_DISARM_PORTS | ARM_ACT_AUTO_ARM_TIMER | ARM_ACT_SIREN_OFF |\
+                             ARM_ACT_DISARM_FLASH)
+#define ARM_ACTS_ALARM      (ARM_ACT_SIREN_ON | ARM_ACT_LED)
+#define ARM_ACTS_SILENCE    (ARM_ACT_SIREN_OFF | ARM_ACT_AUTO_ARM_TIMER)
+
+typedef struct ArmTransition_t
+{
+    uint16_t    actions;
+    uint8_t     next;
+} ArmTransition_t;
+
+// Every state x event pair is defined, dispatch is one lookup
+static const ArmTransition_t armTransitions[ARM_STATE_COUNT][ARM_EVENT_COUNT] =
+{
+    [ARM_STATE_DISARMED] =
+    {
+        [ARM_EVENT_ARM]      = {ARM_ACTS_ARM,                   ARM_STATE_ARMED},
+        [ARM_EVENT_AUTO_ARM] = {ARM_ACT_SET_ARMED,              ARM_STATE_ARMED},
+        [ARM_EVENT_DISARM]   = {ARM_ACTS_DISARM,                ARM_STATE_DISARMED},
+        [ARM_EVENT_SILENCE]  = {ARM_ACTS_DISARM | ARM_ACT_LED,  ARM_STATE_DISARMED},
+        [ARM_EVENT_ALARM]    = {0,                              ARM_STATE_DISARMED},   // Tamper without an armed zone is a module alarm
+    },
+    [ARM_STATE_ARMED] =
+    {
+        [ARM_EVENT_ARM]      = {ARM_ACTS_ARM,                   ARM_STATE_ARMED},
+        [ARM_EVENT_AUTO_ARM] = {0,                              ARM_STATE_ARMED},
+        [ARM_EVENT_DISARM]   = {ARM_ACTS_DISARM,                ARM_STATE_DISARMED},
+        [ARM_EVENT_SILENCE]  = {ARM_ACTS_DISARM | ARM_ACT_LED,  ARM_STATE_DISARMED},
+        [ARM_EVENT_ALARM]    = {ARM_ACTS_ALARM,                 ARM_STATE_ALARMING},
+    },
+    [ARM_STATE_ALARMING] =
+    {
+        [ARM_EVENT_ARM]      = {ARM_ACTS_ARM | ARM_ACT_SIREN_OFF, ARM_STATE_ARMED},
+        [ARM_EVENT_AUTO_ARM] = {0,                              ARM_STATE_ALARMING},
+        [ARM_EVENT_DISARM]   = {ARM_ACTS_DISARM,                ARM_STATE_DISARMED},
+        [ARM_EVENT_SILENCE]  = {ARM_ACTS_SILENCE,               ARM_STATE_SILENT},
+        [ARM_EVENT_ALARM]    = {ARM_ACTS_ALARM,                 ARM_STATE_ALARMING},
+    },
+    [ARM_STATE_SILENT] =
+    {
+        [ARM_EVENT_ARM]      = {ARM_ACTS_ARM,                   ARM_STATE_ARMED},
+        [ARM_EVENT_AUTO_ARM] = {0,                              ARM_STATE_SILENT},     // Ports re-armed, still silent alarming
+        [ARM_EVENT_DISARM]   = {ARM_ACTS_DISARM,                ARM_STATE_DISARMED},
+        [ARM_EVENT_SILENCE]  = {ARM_ACTS_DISARM | ARM_ACT_LED,  ARM_STATE_DISARMED},
+        [ARM_EVENT_ALARM]    = {ARM_ACTS_ALARM,                 ARM_STATE_ALARMING},
+    },
+};
+
+// Alarm events posted by app_arm_alarmEvent() from any context, one pending bit per
+// cause. Reposting a pending cause coalesces into it, so the queue never overflows.
+static volatile uint16_t alarmPending;
+static uint32_t alarmPosted;
+static uint32_t alarmCoalesced;                 // Posts that found their cause already pending
+static uint32_t alarmDropped;                   // Causes lost to a higher one in the same zone
+
+// Handling order, highest priority first
+static const uint8_t alarmPriority[ALARM_CAUSE_COUNT] =
+{
+    POWER_TAMPER_nMASTER_ALARM,
+    DAISY_CHAIN_TAMPER_ALARM,
+    CHANNEL_0_SWITCH_WAS_OPENED,
+    CHANNEL_1_SWITCH_WAS_OPENED,
+    CHANNEL_2_SWITCH_WAS_OPENED,
+    CHANNEL_3_SWITCH_WAS_OPENED,
+    CHANNEL_4_SWITCH_WAS_OPENED,
+    CHANNEL_5_SWITCH_WAS_OPENED,
+    CHANNEL_6_SWITCH_WAS_OPENED,
+    CHANNEL_7_SWITCH_WAS_OPENED,
+    CHANNEL_8_SWITCH_WAS_OPENED,
+    CHANNEL_9_SWITCH_WAS_OPENED,
+    CHANNEL_10_SWITCH_WAS_OPENED,
+    CHANNEL_11_SWITCH_WAS_OPENED,
+};
+
+static ArmTrace_t armTrace[ARM_TRACE_SIZE];
+static uint8_t armTraceHead;                // Next entry to write
+static uint8_t armTraceCount;
 
 
 
 ////////////////////////////////////////////////////////////////
 // Local function prototypes
 static void app_arm_alarm_LimitTimerHandler(SYS_Timer_t *timer);
-static void appDisarmFlashTimerHandler(SYS_Timer_t *timer);
+static void appAutoArmTimerHandler(SYS_Timer_t *timer);
+static bool zoneAutoRequest(ArmZone_t *zone);
+static uint8_t armDispatch(uint8_t zoneNum, uint8_t event, uint8_t cause);
+static void armRunActions(ArmZone_t *zone, uint16_t actions);
+static void tamperAlarmStart(void);
+static void tamperAlarmStop(void);
+
 bool app_arm_is_armed(void);
 
 
@@ -57,7 +202,14 @@ bool app_arm_is_armed(void);
 // Functions
 bool app_arm_is_auto_timer_running(void)
 {
-    return SYS_TimerStarted(&appAutoArmTimer);
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        if (SYS_TimerStarted(&armZones[z].autoArmTimer))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -87,24 +239,13 @@ bool app_arm_is_silentalarming(void)
 ////////////////////////////////////////////////////////////////
 bool app_arm_is_any_alarm_active(void)
 {   	
-    bool result = false;
-    
-    if(app_arm_is_armed())
-    {
-        if(((armAlarmStatus.powerTamper_Alarm) ||\
-            (armAlarmStatus.daisyChainTamper_Alarm) ||\
-            (armAlarmStatus.channel_Alarm) ) )
-        {
-            result = true;
-        }
-        
-    }
-
-    return  result; 
+    // Alarming or silent alarming in any zone, or a tamper with none armed
+    return (((zonesAlarming | zonesSilent) != 0) || tamperAlarming);
 }
 
 ////////////////////////////////////////////////////////////////
-static bool app_arm_auto_request(void)
+// Auto-arm of one zone. Only looks at the zone's channels, other zones are untouched.
+static bool zoneAutoRequest(ArmZone_t *zone)
 {
 
     if (SYS_TimerStarted(&appDisarmDurationTimer))
@@ -117,8 +258,26 @@ static bool app_arm_auto_request(void)
 //    AlarmModuleStatus_t alarmModSts;
 //     alarmModSts.sAlarmModule = app_gen_io_get_AM_status();
     
-    bool channelHasArmed = false; 
+    uint16_t armPorts;
+    uint16_t rearmPorts = 0;
+    uint16_t candidates;
+    
+    autoArmCandidates |= app_gen_io_take_dirty_mask();
+    candidates = autoArmCandidates & zone->channels;
     
+    if( ARM_STATE_SILENT == zone->state )
+    {
+        // Silent alarming re-arms every present port that alarmed
+        rearmPorts = app_gen_io_get_alarming_mask() & zone->channels;
+    }
+    
+    if( 0 == ((candidates | rearmPorts) & app_gen_io_get_present_mask()) )
+    {
+        // No closed channel changed since the last pass, nothing can arm
+        autoArmCandidates &= ~zone->channels;
+        autoArmSkips++;
+        return true;
+    }
 
     #warning "TODO: What are the base arming requriements? Loopback? Powered?"
     
@@ -128,47 +287,38 @@ static bool app_arm_auto_request(void)
         // We have power & nDISARM is HIGH, so we can arm new ports
         
         UART_DBG_TX("\n\n******** Powerd and ArmLB Connected ******** \n\n");
+        autoArmEvaluations++;
+        
+        // A present cable means the switch is pressed and the port is ready to arm.
+        // If we are alarming auto arm doesn't clear/rearm it, unless silent alarming,
+        // then every present port that alarmed is re-armed.
+        armPorts = ((candidates & ~app_gen_io_get_armed_mask()) | rearmPorts) & app_gen_io_get_present_mask();
+        autoArmCandidates &= ~zone->channels;
         
-        // Refreshing all port
-        for(int num = 0; num < CH_COUNT; num++)
+        if( rearmPorts )
         {
-            if( app_gen_io_is_cable_present(num) ) 					
-            {
-                // If a cable is seen then the switch is pressed and its ready to arm
-                // If we are alarming auto arm doesn't clear/rearm it. 
-                
-                if( app_gen_io_is_port_armed(num) == PORT_DISARMED )
-                {
-                    UART_DBG_TX("Armed port from Disarmed State\n");
-                    app_gen_io_set_port_armed(num, SENSOR_ARMED); //set port to armed (!disarmed)
-                    armAlarmStatus.armed = SYSTEM_ARMED;
-                    channelHasArmed = true;
-                    
-                    SYS_TimerStop(&appDisarmFlashTimer);
-                    //port_pin_set_output_level(DISARMED_FLASH_PIN, LOW);
-                }
-                        
-                // this is armed port, is it also silent Alarming?
-                if( (armAlarmStatus.silentAlarm == SILENT_ALARMING ) ) // && )
-                {
-                    UART_DBG_TX("Armed port from Silent ALarming State\n");
-                    app_gen_io_set_port_armed(num, SENSOR_ARMED); //set port to armed (!disarmed)
-                    armAlarmStatus.armed = SYSTEM_ARMED;
-                    channelHasArmed = true;
-                    SYS_TimerStop(&appDisarmFlashTimer);
-                    //port_pin_set_output_level(DISARMED_FLASH_PIN, LOW);
-                }
-            }
+            UART_DBG_TX("Armed ports from Silent ALarming State\n");
+        }
+        
+        if( armPorts )
+        {
+            UART_DBG_TX("Armed ports 0x%03x\n", armPorts);
+            app_gen_io_arm_ports(armPorts);
+            SYS_TimerStop(APP_TIMER(ARM_DISARM_FLASH));
+            //port_pin_set_output_level(DISARMED_FLASH_PIN, LOW);
         }
          
-        if( channelHasArmed || app_gen_io_is_any_port_armed())
+        if( app_gen_io_get_armed_mask() & zone->channels )
         {
-            // There is at least 1 channel armed   
-            armAlarmStatus.armed                    = SYSTEM_ARMED;
+            // There is at least 1 channel of the zone armed
+            armDispatch(zone - armZones, ARM_EVENT_AUTO_ARM, ARM_TRACE_NO_CAUSE);
         }       
-        
-        app_arm_reset_auto_arm_timer();  
-    }        
+    }
+    else
+    {
+        // Try the candidates again later
+        SYS_TimerRestart(&zone->autoArmTimer);
+    }
 
     UART_DBG_TX("\n+++++ AUTO ARM REQUEST COMPLETE +++++\n ");
     return true;
@@ -176,56 +326,88 @@ static bool app_arm_auto_request(void)
 
 static void appAutoArmTimerHandler(SYS_Timer_t *timer)
 {
-    UNUSED(timer);
-
-    app_arm_auto_request();
+    zoneAutoRequest(ARM_ZONE_OF(timer, autoArmTimer));
 }
 
 static void appDisarmDurationTimerHandler(SYS_Timer_t *timer)
 {
     UNUSED(timer);
 
-    SYS_TimerRestart(&appAutoArmTimer);
+    app_arm_set_not_ready(ARM_NOT_READY_DISARM_DURATION, false);
+    app_arm_reset_auto_arm_timer();
 }
 
+// Restarts the auto-arm timer of every zone
 void app_arm_reset_auto_arm_timer(void)
 {
-    SYS_TimerRestart(&appAutoArmTimer);
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        SYS_TimerRestart(&armZones[z].autoArmTimer);
+    }
 #ifdef ENABLE_ARM_DEBUG_MSGS
     UART_DBG_TX("Auto-arm Timer was reset\n");
 #endif
 }
 
+// A cable closed, only its zone waits out the auto-arm time again
+void app_arm_channel_closed(uint8_t channel)
+{
+    if (channel < CH_COUNT)
+    {
+        SYS_TimerRestart(&armZones[channelZone[channel]].autoArmTimer);
+    }
+}
+
 static void app_arm_alarm_LimitTimerHandler(SYS_Timer_t *timer)
 {
-    UNUSED(timer);
+    ArmZone_t *zone = ARM_ZONE_OF(timer, alarmLimitTimer);
 
-    app_arm_silence_alarm();
+    // Only runs while the zone is alarming, goes silent
+    armDispatch(zone - armZones, ARM_EVENT_SILENCE, ARM_TRACE_NO_CAUSE);
 }
 
 void app_arm_init(void)
 {
-    app_arm_disarm(0);
-    disarmDuration = 0;
+    uint32_t autoArmTime;
 
     if (APP_EEPROM_MODEL_TYPE_FACTORY == app_eeprom_read_connect_wanted())
     {
-        appAutoArmTimer.interval = DEFAULT_MODE_AUTO_ARM_TIME;
+        autoArmTime = DEFAULT_MODE_AUTO_ARM_TIME;
         // app_arm_set_auto_arm_timer_to_default_time();
     }
     else
     {
-        appAutoArmTimer.interval = AUTO_ARM_TIME;
+        autoArmTime = AUTO_ARM_TIME;
         // app_arm_set_auto_arm_timer_to_default_time();
     }
 
-    appAutoArmTimer.mode    = SYS_TIMER_INTERVAL_MODE;
-    appAutoArmTimer.handler = appAutoArmTimerHandler;
-    SYS_TimerStart(&appAutoArmTimer);
+    // Every channel starts in zone 0
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        ArmZone_t *zone = &armZones[z];
+
+        zone->channels                 = (0 == z) ? CH_ALL_MASK : 0;
+        zone->state                    = ARM_STATE_DISARMED;
+        zone->autoArmTimer.interval    = autoArmTime;
+        zone->autoArmTimer.slack       = AUTO_ARM_SLACK;
+        zone->autoArmTimer.mode        = SYS_TIMER_INTERVAL_MODE;
+        zone->autoArmTimer.handler     = appAutoArmTimerHandler;
+        zone->alarmLimitTimer.interval = ALARM_TIME_BEFORE_SILENT;   // 10 min -> 5min 8/25/2020
+        zone->alarmLimitTimer.mode     = SYS_TIMER_INTERVAL_MODE;
+        zone->alarmLimitTimer.handler  = app_arm_alarm_LimitTimerHandler;
+    }
 
-    app_arm_alarm_LimitTimer.interval = ALARM_TIME_BEFORE_SILENT;           // 10 min -> 5min 8/25/2020
-    app_arm_alarm_LimitTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-    app_arm_alarm_LimitTimer.handler  = app_arm_alarm_LimitTimerHandler;
+    memset(channelZone, 0, sizeof(channelZone));
+    zonesArmed        = 0;
+    zonesAlarming     = 0;
+    zonesSilent       = 0;
+    zonesChannelAlarm = 0;
+    tamperAlarming    = false;
+    armTraceHead      = 0;
+    armTraceCount     = 0;
+
+    app_arm_disarm(0);
+    disarmDuration = 0;
 
     appDisarmDurationTimer.interval = DISARM_DURATION;
     appDisarmDurationTimer.mode     = SYS_TIMER_INTERVAL_MODE;
@@ -240,10 +422,6 @@ void app_arm_init(void)
     pin_conf.direction = PORT_PIN_DIR_OUTPUT;
     port_pin_set_config(DISARMED_FLASH_PIN, &pin_conf);
     port_pin_set_output_level(DISARMED_FLASH_PIN, HIGH);         // High => N-Channel FET Should default connected to detect cables at start. 
-    
-    appDisarmFlashTimer.interval = DISARM_FLASH_TIME;           // delay
-    appDisarmFlashTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-    appDisarmFlashTimer.handler  = appDisarmFlashTimerHandler;
 }
 
 // ****************************************************************************
@@ -265,6 +443,11 @@ void app_arm_set_PowerTamper_armed(bool powerTamperArmedState)
 void app_arm_clear_PowerTamper_alarm(void)
 {
     armAlarmStatus.powerTamper_Alarm = DIDNT_ALARM;
+    
+    if (DIDNT_ALARM == armAlarmStatus.daisyChainTamper_Alarm)
+    {
+        tamperAlarmStop();
+    }
 }
 
 // ****************************************************************************
@@ -276,10 +459,17 @@ void app_arm_set_daisyChainTamper_armed(bool daisyChainArmedState)
     {
         armAlarmStatus.daisyChainTamper_Armed = SYSTEM_ARMED; 
         armAlarmStatus.daisyChainTamper_Alarm = DIDNT_ALARM;
+        app_arm_set_not_ready(ARM_NOT_READY_NO_DAISY_CHAIN, false);
+        
+        if (DIDNT_ALARM == armAlarmStatus.powerTamper_Alarm)
+        {
+            tamperAlarmStop();
+        }
     }
     else
     {
         armAlarmStatus.daisyChainTamper_Armed = SYSTEM_DISARMED;
+        app_arm_set_not_ready(ARM_NOT_READY_NO_DAISY_CHAIN, true);
     }  
 }
 
@@ -293,7 +483,12 @@ bool app_arm_get_daisyChainTamper_armed(void)
 // *****************************************************************************
 uint8_t app_arm_request(bool disarmOnFail, uint8_t armIgnore)
 {
-    app_arm_auto_request();
+    // An explicit request looks at every channel of every zone
+    autoArmCandidates = CH_ALL_MASK;
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        zoneAutoRequest(&armZones[z]);
+    }
     
     
 //     PuckStatus_t puckStatus;
@@ -393,26 +588,37 @@ uint8_t app_arm_request(bool disarmOnFail, uint8_t armIgnore)
 // ****************************************************************************
 bool app_arm_silence_alarm(void)
 {
-    app_arm_reset_auto_arm_timer();
+    uint8_t alarming = zonesAlarming;
+
+    // Alarming zones go silent. With none alarming every zone (including silent
+    // alarming ones) disarms. Have caller to send status, as it may want to send a key event.
+    if (tamperAlarming)
+    {
+        tamperAlarmStop();
+        if (!alarming)
+        {
+            return true;
+        }
+    }
 
-    if ((app_arm_is_any_alarm_active()) && (armAlarmStatus.silentAlarm == NOT_SILENT_ALARMING))
+    if (alarming)
     {
-        armAlarmStatus.silentAlarm = SILENT_ALARMING;
-        app_buzzer_alarm_stop();                   // Silence the alarm
-        SYS_TimerStop(&app_arm_alarm_LimitTimer);  // Don't come here again
-        // Have caller to send status, as it may want to send a key event.
-        // app_lwmesh_send_status();
+        for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+        {
+            if (alarming & (1u << z))
+            {
+                armDispatch(z, ARM_EVENT_SILENCE, ARM_TRACE_NO_CAUSE);
+            }
+        }
         return true;  // Silent Alarming
     }
-    else
+
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
     {
-        // Disarm
-        app_led_update();
-        app_arm_disarm(0);
-        // Have caller to send status, as it may want to send a key event.
-        // app_lwmesh_send_status();
-        return false;  // Couldn't enter silent alarming mode
+        armDispatch(z, ARM_EVENT_SILENCE, ARM_TRACE_NO_CAUSE);
     }
+    disarmDuration = 0;
+    return false;  // Couldn't enter silent alarming mode
 }
 
 // *****************************************************************************************************
@@ -420,37 +626,22 @@ bool app_arm_silence_alarm(void)
 // *****************************************************************************************************
 void app_arm_arm(void)
 {
-    // Refreshing all port
-    for(int num = 0; num < CH_COUNT; num++)
+    // If a cable is seen then the switch is pressed and its ready to arm, arm all
+    // present ports that are still disarmed in one go
+    if( app_gen_io_arm_ports(app_gen_io_get_present_mask() & ~app_gen_io_get_armed_mask()) )
     {
-        if(app_gen_io_is_cable_present(num))
+        SYS_TimerStop(APP_TIMER(ARM_DISARM_FLASH));
+        port_pin_set_output_level(DISARMED_FLASH_PIN, HIGH);
+    }
+    
+    // A zone with no channels has nothing to arm, it stays open to ZC
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        if (armZones[z].channels)
         {
-            // If a cable is seen then the switch is pressed and its ready to arm       
-            if( !app_gen_io_is_port_armed(num) ) 			    // this is disarmed port
-            {
-                app_gen_io_set_port_armed(num, SENSOR_ARMED); //set port to armed (!disarmed)
-                armAlarmStatus.armed = SYSTEM_ARMED;
-                
-                SYS_TimerStop(&appDisarmFlashTimer);
-                port_pin_set_output_level(DISARMED_FLASH_PIN, HIGH);
-            }
+            armDispatch(z, ARM_EVENT_ARM, ARM_TRACE_NO_CAUSE);
         }
-        
-//         if( (armAlarmStatus.silentAlarm) )
-//         {
-//             app_gen_io_set_port_armed(i, SENSOR_DISARMED);
-//         }
     }
-    
-    
-    armAlarmStatus.armed                    = SYSTEM_ARMED;
-    armAlarmStatus.silentAlarm              = NOT_SILENT_ALARMING;  
-    armAlarmStatus.channel_Alarm            = DIDNT_ALARM;
-    armAlarmStatus.daisyChainTamper_Alarm   = DIDNT_ALARM;
-
-    SYS_TimerStop(&appDisarmDurationTimer);
-
-    app_led_update();
 }
 
 // ****************************************************************************
@@ -463,44 +654,87 @@ void app_arm_disarm(uint16_t duration)
     {
         appDisarmDurationTimer.interval = 1000 * duration;
         SYS_TimerRestart(&appDisarmDurationTimer);
+        app_arm_set_not_ready(ARM_NOT_READY_DISARM_DURATION, true);
     }
 
-    armAlarmStatus.armed                        = SYSTEM_DISARMED;
-    armAlarmStatus.silentAlarm                  = NOT_SILENT_ALARMING;
-    armAlarmStatus.powerTamper_Alarm            = DIDNT_ALARM;
-    armAlarmStatus.channel_Alarm                = DIDNT_ALARM;
-    armAlarmStatus.daisyChainTamper_Alarm       = DIDNT_ALARM;
-    
-    for(int num = 0; num < CH_COUNT; num++)
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
     {
-        app_gen_io_set_port_armed(num, SENSOR_DISARMED);        
+        armDispatch(z, ARM_EVENT_DISARM, ARM_TRACE_NO_CAUSE);
     }
-    
-    
-    // Needs to exist for the condition when the switch is lifted after alarm
-    // timeout occurs, that's not a disarm or a re-arm state
-    app_arm_reset_auto_arm_timer();
+    tamperAlarmStop();
+}
 
-//     app_led_update();
-//     app_led_control(1, APP_LED_WHITE_EXTERNAL, 4);
-    app_buzzer_alarm_stop();
-    SYS_TimerStop(&app_arm_alarm_LimitTimer);   // try to silentAlarm if not alarming
-    
-    SYS_TimerStart(&appDisarmFlashTimer);       //
+// Disarms one zone, the other zones keep their state and timers
+void app_arm_disarm_zone(uint8_t zoneNum)
+{
+    if (zoneNum < ARM_ZONE_COUNT)
+    {
+        armDispatch(zoneNum, ARM_EVENT_DISARM, ARM_TRACE_NO_CAUSE);
+    }
 }
 
 // ****************************************************************************
-//		FUNCTION TO ALARM THE DEVICE
+//		FUNCTION TO ALARM THE DEVICE - posts the cause, safe from any context
 // ****************************************************************************
 void app_arm_alarmEvent(uint8_t alarmCause)
 {
-    bool newAlarm = false;
+    uint16_t bit;
+    
+    if (alarmCause >= ALARM_CAUSE_COUNT)
+    {
+        return;
+    }
     
     if( (SYSTEM_ARMED == armAlarmStatus.armed) ||\
         (SYSTEM_ARMED == armAlarmStatus.daisyChainTamper_Armed ) ||\
         (SYSTEM_ARMED == armAlarmStatus.powerTamper_Armed) )
     {
         // Either a channel is armed or the system alarms (power daisy chain) are armed
+        bit = 1u << alarmCause;
+        
+        cpu_irq_enter_critical();
+        alarmPosted++;
+        if (alarmPending & bit)
+        {
+            alarmCoalesced++;
+        }
+        alarmPending |= bit;
+        cpu_irq_leave_critical();
+        
+        SYS_TimerStart(APP_TIMER(ARM_ALARM_EVENT));
+    }
+}
+
+
+// Handles every pending cause in priority order. However many arrived, each zone gets
+// one ARM_EVENT_ALARM for its highest cause. Channel causes go to the channel's zone,
+// tamper causes to every armed zone. A tamper with no zone armed sounds the module
+// siren without touching any zone.
+void alarmEventTimerHandler(SYS_Timer_t *timer)
+{
+    uint16_t pending;
+    uint8_t zoneCause[ARM_ZONE_COUNT];
+    uint8_t alarmZones = 0;
+    uint8_t causeZones;
+    
+    UNUSED(timer);
+    memset(zoneCause, ARM_TRACE_NO_CAUSE, sizeof(zoneCause));
+    
+    cpu_irq_enter_critical();
+    pending = alarmPending;
+    alarmPending = 0;
+    cpu_irq_leave_critical();
+    
+    for (uint8_t i = 0; pending && (i < ALARM_CAUSE_COUNT); i++)
+    {
+        uint8_t alarmCause = alarmPriority[i];
+        
+        if (!(pending & (1u << alarmCause)))
+        {
+            continue;
+        }
+        pending &= ~(1u << alarmCause);
+        
         switch (alarmCause)
         {
             case CHANNEL_0_SWITCH_WAS_OPENED:
@@ -515,92 +749,429 @@ void app_arm_alarmEvent(uint8_t alarmCause)
             case CHANNEL_9_SWITCH_WAS_OPENED:
             case CHANNEL_10_SWITCH_WAS_OPENED:
             case CHANNEL_11_SWITCH_WAS_OPENED:
-                armAlarmStatus.channel_Alarm            = CAUSED_ALARM;
-                newAlarm                                = true;
+                if (alarmCause >= CH_COUNT)
+                {
+                    alarmDropped++;
+                    continue;
+                }
+                causeZones = 1u << channelZone[alarmCause];
+                zonesChannelAlarm |= causeZones;
                 UART_DBG_TX("CHANNEL ALARMED");
                 break;
 
             case POWER_TAMPER_nMASTER_ALARM:
                 armAlarmStatus.powerTamper_Alarm        = CAUSED_ALARM;
-                newAlarm                                = true;
+                causeZones = zonesArmed;
                 UART_DBG_TX("POWER TAMPER ALARM");
                 break;
             
             case DAISY_CHAIN_TAMPER_ALARM:
                 armAlarmStatus.daisyChainTamper_Alarm   = CAUSED_ALARM;
-                newAlarm                                = true;
+                causeZones = zonesArmed;
                 UART_DBG_TX("DAISY CHAIN TAMPER ALARM");
                 break;
 
             default:
-                break;
+                alarmDropped++;
+                continue;
+        }
+        
+        if (0 == causeZones)
+        {
+            tamperAlarmStart();
+            continue;
+        }
+        
+        for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+        {
+            if (!(causeZones & (1u << z)))
+            {
+                continue;
+            }
+            
+            if (ARM_TRACE_NO_CAUSE == zoneCause[z])
+            {
+                zoneCause[z] = alarmCause;
+                alarmZones |= 1u << z;
+            }
+            else
+            {
+                alarmDropped++;
+            }
         }
+    }
+    
+    for (uint8_t z = 0; alarmZones && (z < ARM_ZONE_COUNT); z++)
+    {
+        if (alarmZones & (1u << z))
+        {
+            alarmZones &= ~(1u << z);
+            armDispatch(z, ARM_EVENT_ALARM, zoneCause[z]);
+        }
+    }
+}
+
+
+void app_arm_get_auto_arm_stats(uint32_t *evaluations, uint32_t *skips)
+{
+    *evaluations = autoArmEvaluations;
+    *skips       = autoArmSkips;
+}
+
+
+void app_arm_get_alarm_event_stats(uint32_t *posted, uint32_t *coalesced, uint32_t *dropped)
+{
+    cpu_irq_enter_critical();
+    *posted    = alarmPosted;
+    *coalesced = alarmCoalesced;
+    *dropped   = alarmDropped;
+    cpu_irq_leave_critical();
+}
+
+// ****************************************************************************
+//		STATE MACHINE - task context only
+// ****************************************************************************
+static uint8_t armDispatch(uint8_t zoneNum, uint8_t event, uint8_t cause)
+{
+    ArmZone_t *zone = &armZones[zoneNum];
+    const ArmTransition_t *transition = &armTransitions[zone->state][event];
+    ArmTrace_t *trace = &armTrace[armTraceHead];
+    uint8_t bit = 1u << zoneNum;
+
+    trace->timeMs = SYS_Timer_Time();
+    trace->zone   = zoneNum;
+    trace->event  = event;
+    trace->cause  = cause;
+    trace->from   = zone->state;
+    trace->to     = transition->next;
+
+    armTraceHead = (armTraceHead + 1) & (ARM_TRACE_SIZE - 1);
+    if (armTraceCount < ARM_TRACE_SIZE)
+    {
+        armTraceCount++;
+    }
+
+    zone->state = transition->next;
+    zonesAlarming = (ARM_STATE_ALARMING == zone->state) ? (zonesAlarming | bit) : (zonesAlarming & ~bit);
+    zonesSilent   = (ARM_STATE_SILENT == zone->state) ? (zonesSilent | bit) : (zonesSilent & ~bit);
+
+    armRunActions(zone, transition->actions);
+
+    // Module summary of the zones
+    armAlarmStatus.armed         = zonesArmed ? SYSTEM_ARMED : SYSTEM_DISARMED;
+    armAlarmStatus.silentAlarm   = (zonesSilent && !zonesAlarming) ? SILENT_ALARMING : NOT_SILENT_ALARMING;
+    armAlarmStatus.channel_Alarm = zonesChannelAlarm ? CAUSED_ALARM : DIDNT_ALARM;
+
+    return zone->state;
+}
+
 
-        if (newAlarm)
+static void armRunActions(ArmZone_t *zone, uint16_t actions)
+{
+    uint8_t bit = 1u << (zone - armZones);
+    bool anyAlarm = ((zonesAlarming | zonesSilent) != 0);
+
+    // The actions below see the zone's new armed flag
+    if (actions & ARM_ACT_SET_ARMED)
+    {
+        zonesArmed |= bit;
+    }
+
+    if (actions & ARM_ACT_CLEAR_ARMED)
+    {
+        zonesArmed &= ~bit;
+    }
+
+    if (actions & ARM_ACT_CLEAR_ALARMS)
+    {
+        zonesChannelAlarm &= ~bit;
+
+        // Tamper alarms are module wide, they clear with the last alarming zone
+        if (!anyAlarm)
+        {
+            armAlarmStatus.daisyChainTamper_Alarm = DIDNT_ALARM;
+        }
+    }
+
+    if ((actions & ARM_ACT_CLEAR_POWER_ALARM) && !anyAlarm)
+    {
+        armAlarmStatus.powerTamper_Alarm = DIDNT_ALARM;
+    }
+
+    if (actions & ARM_ACT_DISARM_PORTS)
+    {
+        app_gen_io_disarm_ports(zone->channels);
+        autoArmCandidates |= zone->channels;
+        
+        // Causes posted before the disarm don't alarm after it. Channel causes
+        // are numbered like the channels.
+        cpu_irq_enter_critical();
+        alarmPending &= zonesArmed ? ~zone->channels : 0;
+        cpu_irq_leave_critical();
+    }
+
+    if (actions & ARM_ACT_AUTO_ARM_TIMER)
+    {
+        // Needs to exist for the condition when the switch is lifted after alarm
+        // timeout occurs, that's not a disarm or a re-arm state
+        SYS_TimerRestart(&zone->autoArmTimer);
+    }
+
+    if (actions & ARM_ACT_STOP_DURATION)
+    {
+        SYS_TimerStop(&appDisarmDurationTimer);
+        app_arm_set_not_ready(ARM_NOT_READY_DISARM_DURATION, false);
+    }
+
+    if (actions & ARM_ACT_SIREN_ON)
+    {
+        SYS_TimerStart(&zone->alarmLimitTimer);
+        app_buzzer_alarm_start();
+    }
+
+    if (actions & ARM_ACT_SIREN_OFF)
+    {
+        SYS_TimerStop(&zone->alarmLimitTimer);      // Don't come here again
+
+        if (!zonesAlarming && !tamperAlarming)
         {
-            armAlarmStatus.silentAlarm = NOT_SILENT_ALARMING;
-            SYS_TimerStart(&app_arm_alarm_LimitTimer);
-            app_buzzer_alarm_start();
+            app_buzzer_alarm_stop();
         }
+    }
+
+    if ((actions & ARM_ACT_DISARM_FLASH) && !zonesArmed)
+    {
+        SYS_TimerStart(APP_TIMER(ARM_DISARM_FLASH));
+    }
+
+    if (actions & ARM_ACT_LED)
+    {
         app_led_update();
     }
 }
 
+
+// ****************************************************************************
+//		MODULE TAMPER ALARM - a tamper cause with no zone armed
+// ****************************************************************************
+static void tamperAlarmStart(void)
+{
+    if (!tamperAlarming)
+    {
+        tamperAlarming = true;
+        SYS_TimerStart(APP_TIMER(ARM_TAMPER_LIMIT));
+        app_buzzer_alarm_start();
+        app_led_update();
+    }
+}
+
+
+// The siren stops, the tamper causes stay reported until their input clears them or a disarm
+static void tamperAlarmStop(void)
+{
+    if (tamperAlarming)
+    {
+        tamperAlarming = false;
+        SYS_TimerStop(APP_TIMER(ARM_TAMPER_LIMIT));
+
+        if (!zonesAlarming)
+        {
+            app_buzzer_alarm_stop();
+        }
+        app_led_update();
+    }
+}
+
+
+void tamperLimitTimerHandler(SYS_Timer_t *timer)
+{
+    UNUSED(timer);
+
+    tamperAlarmStop();
+}
+
+
+uint8_t app_arm_get_state(uint8_t zoneNum)
+{
+    return (zoneNum < ARM_ZONE_COUNT) ? armZones[zoneNum].state : ARM_STATE_DISARMED;
+}
+
+
+uint16_t app_arm_get_zone_channels(uint8_t zoneNum)
+{
+    return (zoneNum < ARM_ZONE_COUNT) ? armZones[zoneNum].channels : 0;
+}
+
+
+// Moves the channels in channelMask to zoneNum. Every zone giving or taking
+// channels has to be disarmed.
+bool app_arm_assign_zone_channels(uint8_t zoneNum, uint16_t channelMask)
+{
+    uint8_t touched = 1u << zoneNum;
+
+    channelMask &= CH_ALL_MASK;
+
+    if (zoneNum >= ARM_ZONE_COUNT)
+    {
+        return false;
+    }
+
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        if (armZones[z].channels & channelMask)
+        {
+            touched |= 1u << z;
+        }
+    }
+
+    if (touched & zonesArmed)
+    {
+        return false;
+    }
+
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        armZones[z].channels &= ~channelMask;
+    }
+    armZones[zoneNum].channels |= channelMask;
+
+    for (uint8_t num = 0; num < CH_COUNT; num++)
+    {
+        if (channelMask & CH_MASK(num))
+        {
+            channelZone[num] = zoneNum;
+        }
+    }
+
+    autoArmCandidates |= channelMask;
+    SYS_TimerRestart(&armZones[zoneNum].autoArmTimer);
+    return true;
+}
+
+
+bool app_arm_set_zone_times(uint8_t zoneNum, uint32_t autoArmMs, uint32_t alarmLimitMs)
+{
+    if ((zoneNum >= ARM_ZONE_COUNT) || (0 == autoArmMs) || (0 == alarmLimitMs))
+    {
+        return false;
+    }
+
+    armZones[zoneNum].autoArmTimer.interval    = autoArmMs;
+    armZones[zoneNum].alarmLimitTimer.interval = alarmLimitMs;
+    return true;
+}
+
+
+void app_arm_get_zone_times(uint8_t zoneNum, uint32_t *autoArmMs, uint32_t *alarmLimitMs)
+{
+    *autoArmMs    = (zoneNum < ARM_ZONE_COUNT) ? armZones[zoneNum].autoArmTimer.interval : 0;
+    *alarmLimitMs = (zoneNum < ARM_ZONE_COUNT) ? armZones[zoneNum].alarmLimitTimer.interval : 0;
+}
+
+
+// age 0 is the latest transition. False once age reaches the number kept.
+bool app_arm_get_trace(uint8_t age, ArmTrace_t *trace)
+{
+    if (age >= armTraceCount)
+    {
+        return false;
+    }
+
+    *trace = armTrace[(armTraceHead - 1 - age) & (ARM_TRACE_SIZE - 1)];
+    return true;
+}
+
 uint16_t app_arm_get_alarm_status(void)
 {
-    return armAlarmStatus.sAlarm;
+    AlarmStatus_t packed;
+    
+    packed.sAlarm                 = 0;
+    packed.armed                  = armAlarmStatus.armed;
+    packed.silentAlarm            = armAlarmStatus.silentAlarm;
+    packed.channel_Alarm          = armAlarmStatus.channel_Alarm;
+    packed.powerTamper_Armed      = armAlarmStatus.powerTamper_Armed;
+    packed.powerTamper_Alarm      = armAlarmStatus.powerTamper_Alarm;
+    packed.daisyChainTamper_Alarm = armAlarmStatus.daisyChainTamper_Alarm;
+    packed.daisyChainTamper_Armed = armAlarmStatus.daisyChainTamper_Armed;
+    
+    return packed.sAlarm;
 }
 
 void app_arm_check_why_arm_failed(void)
 {
-//     PuckStatus_t puckStatus;
-//     BaseStatus_t baseStatus;
-//     puckStatus.sPuck = app_gen_io_get_puck_status();
-//     baseStatus.sBase = app_puckToBaseCom_get_status();
-// 
-//     if (!app_rfid_state_get_armOK())
-//     {
-//         printf("\tRFID not ready\n");
-//     }
-// 
-//     if (TETHER_OPENED == puckStatus.noTether)
-//     {
-//         printf("\tNo Tether\n");
-//     }
-// 
-//     if (baseStatus.notPowered)
-//     {
-//         printf("\tBase Not Powered\n");
-//     }
-// 
-//     if (puckStatus.puckSwitchLifted)
-//     {
-//         printf("\tPuck Switch Lifted\n");
-//     }
-// 
-//     if (!app_eeprom_key_table_count_valid())
-//     {
-//         printf("\tInvalid Key table count\n");
-//     }
+    uint32_t notReady = app_arm_get_not_ready();
+    uint16_t noCable  = (uint16_t)(notReady >> ARM_NOT_READY_CABLE_SHIFT);
+
+    UART_TX("\tNot ready: 0x%08lx\n", (unsigned long)notReady);
+
+    if (notReady & ARM_NOT_READY_BOOTING)
+    {
+        UART_TX("\tInputs not settled\n");
+    }
+
+    if (notReady & ARM_NOT_READY_NO_POWER)
+    {
+        UART_TX("\tNot Powered\n");
+    }
+
+    if (notReady & ARM_NOT_READY_nDISARM)
+    {
+        UART_TX("\tnDISARM low\n");
+    }
+
+    if (notReady & ARM_NOT_READY_DISARM_DURATION)
+    {
+        UART_TX("\tDisarm duration running\n");
+    }
+
+    if (notReady & ARM_NOT_READY_NO_DAISY_CHAIN)
+    {
+        UART_TX("\tNo daisy chain heartbeat\n");
+    }
+
+    if (noCable == CH_ALL_MASK)
+    {
+        UART_TX("\tNo cable on any channel\n");
+    }
 }
 
-void app_arm_set_auto_arm_timer_to_default_time(bool defaultArmTime)
+// O(1), every reason is updated where its input changes
+uint32_t app_arm_get_not_ready(void)
 {
-    if (defaultArmTime)
+    uint16_t noCable = ~app_gen_io_get_present_mask() & CH_ALL_MASK;
+
+    return armNotReady | ((uint32_t)noCable << ARM_NOT_READY_CABLE_SHIFT);
+}
+
+// Safe from any context
+void app_arm_set_not_ready(uint8_t reasons, bool notReady)
+{
+    cpu_irq_enter_critical();
+    if (notReady)
     {
-        appAutoArmTimer.interval = DEFAULT_MODE_AUTO_ARM_TIME;
+        armNotReady |= reasons;
     }
     else
     {
-        appAutoArmTimer.interval = AUTO_ARM_TIME;
+        armNotReady &= ~reasons;
+    }
+    cpu_irq_leave_critical();
+}
+
+void app_arm_set_auto_arm_timer_to_default_time(bool defaultArmTime)
+{
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        armZones[z].autoArmTimer.interval = defaultArmTime ? DEFAULT_MODE_AUTO_ARM_TIME : AUTO_ARM_TIME;
     }
-    SYS_TimerRestart(&appAutoArmTimer);
+    app_arm_reset_auto_arm_timer();
 }
 
 void app_arm_stop_DisarmDuration_timer(void)
 {
     SYS_TimerStop(&appDisarmDurationTimer);
-    SYS_TimerRestart(&appAutoArmTimer);
+    app_arm_set_not_ready(ARM_NOT_READY_DISARM_DURATION, false);
+    app_arm_reset_auto_arm_timer();
 }
 
 
@@ -629,7 +1200,7 @@ bool app_arm_is_daisyChain_alarming(void)
     return armAlarmStatus.daisyChainTamper_Alarm;
 }
 
-static void appDisarmFlashTimerHandler(SYS_Timer_t *timer)
+void appDisarmFlashTimerHandler(SYS_Timer_t *timer)
 {
    // port_pin_toggle_output_level(DISARMED_FLASH_PIN);
 }
@@ -16,6 +16,11 @@
 #ifndef APP_ARM_H_
 #define APP_ARM_H_
 
+#define DISARM_FLASH_TIME          1000     // Milli-seconds till pulse
+#define DISARM_FLASH_SLACK         50       // Milli-seconds the pulse may be late
+#define ALARM_TIME_BEFORE_SILENT   300000   // Limit changed from 10 min -> 5 min 8/25/2020
+
+// Wire image of the arm/alarm state, built by app_arm_get_alarm_status()
 COMPILER_PACK_SET(1)
 
 typedef struct AlarmStatus_t
@@ -86,8 +91,66 @@ enum  // Alarm-able Events in void app_arm_alarmEvent(uint8_t alarmCause)
     CHANNEL_11_SWITCH_WAS_OPENED,       // 0x00
     POWER_TAMPER_nMASTER_ALARM,         // 0x00
     DAISY_CHAIN_TAMPER_ALARM,           // 0x05
+    ALARM_CAUSE_COUNT,
+};
+
+// Arm/alarm state machine, see armTransitions[] in app_arm.c
+enum arm_state
+{
+    ARM_STATE_DISARMED,
+    ARM_STATE_ARMED,
+    ARM_STATE_ALARMING,
+    ARM_STATE_SILENT,                   // Alarmed, siren timed out or silenced
+    ARM_STATE_COUNT,
+};
+
+enum arm_event
+{
+    ARM_EVENT_ARM,                      // Explicit arm
+    ARM_EVENT_AUTO_ARM,                 // Auto-arm armed at least one port
+    ARM_EVENT_DISARM,
+    ARM_EVENT_SILENCE,                  // Silence request or alarm time limit
+    ARM_EVENT_ALARM,                    // Any alarm cause, the cause is in the trace
+    ARM_EVENT_COUNT,
+};
+
+// Channel zones, each an independent arm domain with its own state, auto-arm and
+// alarm limit timers. Every channel starts in zone 0, so 1 zone is the whole module.
+#ifndef ARM_ZONE_COUNT
+#define ARM_ZONE_COUNT      1
+#endif
+
+#if (ARM_ZONE_COUNT < 1) || (ARM_ZONE_COUNT > 8)
+#error "ARM_ZONE_COUNT must be between 1 and 8"
+#endif
+
+#define ARM_TRACE_SIZE      16          // Transitions kept, power of 2
+#define ARM_TRACE_NO_CAUSE  0xFF
+
+// One dispatched event
+typedef struct ArmTrace_t
+{
+    uint32_t    timeMs;
+    uint8_t     zone;
+    uint8_t     event;                  // enum arm_event
+    uint8_t     cause;                  // Alarm cause for ARM_EVENT_ALARM, else ARM_TRACE_NO_CAUSE
+    uint8_t     from;                   // enum arm_state
+    uint8_t     to;
+} ArmTrace_t;
+
+// Arm not-ready reasons, app_arm_get_not_ready(). Kept up to date as each input
+// changes, a set bit is a reason arming can't happen now.
+enum
+{
+    ARM_NOT_READY_NO_POWER          = 1 << 0,
+    ARM_NOT_READY_nDISARM           = 1 << 1,   // nDISARM low, intelli-key inserted
+    ARM_NOT_READY_DISARM_DURATION   = 1 << 2,   // Timed disarm running
+    ARM_NOT_READY_NO_DAISY_CHAIN    = 1 << 3,   // Slave hasn't seen the heartbeat, informational
+    ARM_NOT_READY_BOOTING           = 1 << 4,   // Inputs not settled yet
 };
 
+#define ARM_NOT_READY_CABLE_SHIFT   16          // Bit 16 + n = no cable on channel n
+
 enum
 {
     ARM_IGNORE_NONE,
@@ -115,6 +178,8 @@ bool app_arm_is_DisarmDurationTimer_running(void);
 uint16_t app_arm_get_disarmDuration(void);
 uint16_t app_arm_get_alarm_status(void);
 void app_arm_check_why_arm_failed(void);
+uint32_t app_arm_get_not_ready(void);
+void app_arm_set_not_ready(uint8_t reasons, bool notReady);
 void app_arm_set_auto_arm_timer_to_default_time(bool defaultArmTime);
 void app_arm_stop_DisarmDuration_timer(void);
 bool app_arm_get_system_armed(void);
@@ -124,5 +189,15 @@ void app_arm_clear_PowerTamper_alarm(void);
 void app_arm_set_daisyChainTamper_armed(bool daisyChainArmedState);
 bool app_arm_get_daisyChainTamper_armed(void);
 bool app_arm_is_daisyChain_alarming(void);
+uint8_t app_arm_get_state(uint8_t zoneNum);
+uint16_t app_arm_get_zone_channels(uint8_t zoneNum);
+bool app_arm_assign_zone_channels(uint8_t zoneNum, uint16_t channelMask);
+bool app_arm_set_zone_times(uint8_t zoneNum, uint32_t autoArmMs, uint32_t alarmLimitMs);
+void app_arm_get_zone_times(uint8_t zoneNum, uint32_t *autoArmMs, uint32_t *alarmLimitMs);
+void app_arm_disarm_zone(uint8_t zoneNum);
+void app_arm_channel_closed(uint8_t channel);
+void app_arm_get_alarm_event_stats(uint32_t *posted, uint32_t *coalesced, uint32_t *dropped);
+void app_arm_get_auto_arm_stats(uint32_t *evaluations, uint32_t *skips);
+bool app_arm_get_trace(uint8_t age, ArmTrace_t *trace);
 
 #endif /* APP_ARM_H_ */
@@ -12,6 +12,7 @@
 #include "app_arm.h"
 #include "app_buzzer.h"
 #include "app_gen_io.h"
+#include "app_timers.h"
 #include "app_uart.h"  // For debug prints
 #include "app_wdt.h"
 #include "conf_clocks.h"
@@ -24,12 +25,6 @@
 
 // #define ENABLE_BBU_DEBUG_MSGS 1 // Uncomment to print out Debug messages
 
-#ifdef INCLUDE_ALL_DEBUG_FUNCTIONS
-    #define BBU_TIME_LIMIT (1000 * 60 * 5)  // 5 minutes
-#else
-    #define BBU_TIME_LIMIT (1000 * 60 * 60 * 4)  // 4 hours
-#endif
-
 typedef enum AppBbuState_t
 {
     APP_BBU_STATE_ACTIVE,
@@ -38,13 +33,12 @@ typedef enum AppBbuState_t
 } AppBbuState_t;
 
 static AppBbuState_t appBbuState;
-static SYS_Timer_t appBatteryCheckTimer;
-static SLP_Timer_t appBBUTimeLimitTimer;
+
 static uint16_t batteryLevel;
 static bool batteryCharging;
 static bool shelfStorageTimerCompleteFlag;
 
-static void appBatteryCheckTimerHandler(SYS_Timer_t *timer)
+void appBatteryCheckTimerHandler(SYS_Timer_t *timer)
 {
     UNUSED(timer);
 
@@ -53,7 +47,7 @@ static void appBatteryCheckTimerHandler(SYS_Timer_t *timer)
     // we'll just lose a reading and catch one the next time the timer fires.
 }
 
-static void appBBUTimeLimitTimerHandler(SLP_Timer_t *timer)
+void appBBUTimeLimitTimerHandler(SLP_Timer_t *timer)
 {
     UNUSED(timer);
     shelfStorageTimerCompleteFlag = true;
@@ -101,7 +95,7 @@ void app_bbu_request_active(void)
     app_gen_io_set_status_deepSleep(APP_BBU_STATE_ACTIVE);
  //   app_puckToBaseCom_change_Timeout(UART_PING_TIMEOUT);
 
-    SLP_TimerStop(&appBBUTimeLimitTimer);
+    SLP_TimerStop(APP_TIMER(BBU_LIMIT));
     shelfStorageTimerCompleteFlag = false;  // Dont allow shelf storage timeout condition
     app_led_update();
 }
@@ -153,14 +147,8 @@ bool app_bbu_get_battery_charging(void)
 
 void app_bbu_init(void)
 {
-    appBatteryCheckTimer.interval = 20000;
-    appBatteryCheckTimer.mode     = SYS_TIMER_PERIODIC_MODE;
-    appBatteryCheckTimer.handler  = appBatteryCheckTimerHandler;
-    SYS_TimerStart(&appBatteryCheckTimer);
+    SYS_TimerStart(APP_TIMER(BBU_BATTERY_CHECK));
 
-    appBBUTimeLimitTimer.interval = BBU_TIME_LIMIT;
-    appBBUTimeLimitTimer.mode     = SLP_TIMER_INTERVAL_MODE;
-    appBBUTimeLimitTimer.handler  = appBBUTimeLimitTimerHandler;
     shelfStorageTimerCompleteFlag = false;
 
     batteryLevel    = BATTERY_LEVEL_INIT;
@@ -240,7 +228,7 @@ void app_bbu_task(void)
 // 
 // //         if (BASE_UNPOWERED == app_puckToBase_get_baseNotPowered())
 // //         {
-// //             SLP_TimerStart(&appBBUTimeLimitTimer);
+// //             SLP_TimerStart(APP_TIMER(BBU_LIMIT));
 // //         }
 //     }
 
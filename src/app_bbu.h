@@ -9,6 +9,12 @@
 #ifndef APP_BBU_H_
 #define APP_BBU_H_
 
+#ifdef INCLUDE_ALL_DEBUG_FUNCTIONS
+    #define BBU_TIME_LIMIT (1000 * 60 * 5)  // 5 minutes
+#else
+    #define BBU_TIME_LIMIT (1000 * 60 * 60 * 4)  // 4 hours
+#endif
+
 void app_bbu_init(void);
 void app_bbu_task(void);
 void app_bbu_battery_check_ADC_complete_callback(uint16_t bat);
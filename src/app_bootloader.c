@@ -14,12 +14,11 @@
 #include <asf.h>
 #include "app_bootloader.h"
 #include "app_eeprom.h"
+#include "app_timers.h"
 #include "string.h"
 #include "sysTimer.h"
 
 // Prototypes
-static void updateRebootTimerHandler(SYS_Timer_t *timer);
-static void updateTimeoutTimerHandler(SYS_Timer_t *timer);
 void app_bootloader_start_loader(void);
 uint8_t app_bootloader_load(uint16_t blockNumber, uint16_t crc, uint8_t *data);
 static bool app_bootloader_verify_device_type(void);
@@ -30,14 +29,12 @@ static volatile uint16_t totalBlockNumber;
 static volatile uint16_t fileCRC;
 uint32_t curr_prog_addr = APP_STORE_ADDRESS;
 struct nvm_config config;
-static SYS_Timer_t updateTimeoutTimer;
-static SYS_Timer_t updateRebootTimer;
 bool firstBlock = true;
 
 // ************************************************************************************************
 // This function is called when updateRebootTimer expires
 // ************************************************************************************************
-static void updateRebootTimerHandler(SYS_Timer_t *timer)
+void updateRebootTimerHandler(SYS_Timer_t *timer)
 {
     UNUSED(timer);
 
@@ -47,7 +44,7 @@ static void updateRebootTimerHandler(SYS_Timer_t *timer)
 // ************************************************************************************************
 // This function is called when updateTimeoutTimer expires
 // ************************************************************************************************
-static void updateTimeoutTimerHandler(SYS_Timer_t *timer)
+void updateTimeoutTimerHandler(SYS_Timer_t *timer)
 {
     UNUSED(timer);
 
@@ -70,10 +67,7 @@ void app_bootloader_start_loader(void)
     currentBlockNumber = 0;
     fileCRC            = 0;
 
-    updateTimeoutTimer.interval = 5000;
-    updateTimeoutTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-    updateTimeoutTimer.handler  = updateTimeoutTimerHandler;
-    SYS_TimerStart(&updateTimeoutTimer);
+    SYS_TimerStart(APP_TIMER(BOOT_UPDATE_TIMEOUT));
 
     firstBlock = false;
 }
@@ -85,7 +79,7 @@ uint8_t app_bootloader_load(uint16_t blockNumber, uint16_t crc, uint8_t *data)
         app_bootloader_start_loader();
     }
 
-    SYS_TimerRestart(&updateTimeoutTimer);
+    SYS_TimerRestart(APP_TIMER(BOOT_UPDATE_TIMEOUT));
 
     if (currentBlockNumber > blockNumber)
     {
@@ -144,9 +138,9 @@ uint8_t app_bootloader_load(uint16_t blockNumber, uint16_t crc, uint8_t *data)
         // Set Update Pending flag
         app_eeprom_write_update_pending(UPDATE_PENDING_FILE_VALID);
 
-        if (SYS_TimerStarted(&updateTimeoutTimer))
+        if (SYS_TimerStarted(APP_TIMER(BOOT_UPDATE_TIMEOUT)))
         {
-            SYS_TimerStop(&updateTimeoutTimer);
+            SYS_TimerStop(APP_TIMER(BOOT_UPDATE_TIMEOUT));
         }
 
         return UPDATE_STATUS_FILE_TRANSFER_COMPLETE;
@@ -230,10 +224,7 @@ void app_bootloader_data_handler(uint8_t updateCMD, uint16_t updateBlockNumber,
                 app_eeprom_write_update_pending(UPDATE_PENDING_PERFORM_UPDATE);
 
                 // Reset to bootloader to switch in new app
-                updateRebootTimer.interval = 500;
-                updateRebootTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-                updateRebootTimer.handler  = updateRebootTimerHandler;
-                SYS_TimerStart(&updateRebootTimer);
+                SYS_TimerStart(APP_TIMER(BOOT_UPDATE_REBOOT));
             }
             else
             {
@@ -16,6 +16,7 @@
 
 #define DAISY_CHAIN_ALARM_TIME          3000    // Milli-seconds till alarm
 #define DAISY_CHAIN_PULSE_TIME          500     // Milli-seconds till pulse
+#define DAISY_CHAIN_PULSE_SLACK         25      // Milli-seconds the pulse may be late
 
 
 // --------------------------------------------------------------------------
@@ -49,6 +50,7 @@ void app_daisychain_init(void)
      if(AM_IS_MASTER == alarmModuleStatus.isMaster)
      {
          // We're the master and generate the heartbeat on the daisychain, ignore daisy chain alarms. 
+         app_arm_set_not_ready(ARM_NOT_READY_NO_DAISY_CHAIN, false);
          
          struct port_config pin_conf;
          port_get_config_defaults(&pin_conf);
@@ -58,6 +60,7 @@ void app_daisychain_init(void)
          port_pin_set_output_level(ARM_PIN, LOW);
          
          daisyChainCountdownTimer.interval = DAISY_CHAIN_PULSE_TIME;            // delay
+         daisyChainCountdownTimer.slack    = DAISY_CHAIN_PULSE_SLACK;
      }
      else
      {daisyChainCountdownTimer.interval = DAISY_CHAIN_PULSE_TIME;            // delay
@@ -75,6 +78,7 @@ void app_daisychain_init(void)
         config_extint_chan.gpio_pin_mux       = ARM_EIC_MUX;
         config_extint_chan.gpio_pin_pull      = EXTINT_PULL_UP;  // <<<===
         config_extint_chan.detection_criteria = EXTINT_DETECT_BOTH;
+        config_extint_chan.filter_input_signal = EIC_INPUT_FILTER;
         extint_chan_set_config(ARM_EIC_LINE, &config_extint_chan);
         
         extint_register_callback(extint_callback_debounce_daisyChain, ARM_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
@@ -55,7 +55,12 @@
 
 #define EEPROM_PAGE_USER_CONFIG_OPTIONS   56  // This is the User Configuration (Volume, Alarms, etc)
 #define EEPROM_INDEX_USER_CONFIG_OPTIONS  0   // 00-31
-#define EEPROM_INDEX_USER_CONFIG_RESERVED 32  // 32-59
+#define EEPROM_INDEX_DEBOUNCE_CONFIG      32  // 32-50
+#define EEPROM_INDEX_USER_CONFIG_RESERVED 51  // 51-59
+
+#if (EEPROM_INDEX_DEBOUNCE_CONFIG + EEPROM_BYTES_DEBOUNCE_CONFIG) > EEPROM_INDEX_USER_CONFIG_RESERVED
+#error "Debounce config overlaps the reserved user config bytes"
+#endif
 
 #define EEPROM_PAGE_PROG_KEY_TABLE       57
 #define EEPROM_PAGE_PROG_KEY_TABLE_PAGES 1
@@ -841,3 +846,41 @@ void app_eeprom_write_userConfig(uint8_t *userConfiguration)
         eeprom_emulator_commit_page_buffer();
     }
 }
+
+// ********************************************************************
+// Debounce Config, in the user config page after the user config options
+// #define EEPROM_PAGE_USER_CONFIG_OPTIONS		56
+// #define EEPROM_INDEX_DEBOUNCE_CONFIG			32
+// #define EEPROM_BYTES_DEBOUNCE_CONFIG			19
+// ********************************************************************
+
+enum status_code app_eeprom_read_debounceConfig(uint8_t *debounceConfig)
+{
+    uint8_t page_data[EEPROM_PAGE_SIZE];
+    enum status_code status = eeprom_emulator_read_page(EEPROM_PAGE_USER_CONFIG_OPTIONS, page_data);
+
+    if (STATUS_OK == status)
+    {
+        memcpy(debounceConfig, &page_data[EEPROM_INDEX_DEBOUNCE_CONFIG], EEPROM_BYTES_DEBOUNCE_CONFIG);
+    }
+    return status;
+}
+
+enum status_code app_eeprom_write_debounceConfig(const uint8_t *debounceConfig)
+{
+    uint8_t page_data[EEPROM_PAGE_SIZE];
+    enum status_code status = eeprom_emulator_read_page(EEPROM_PAGE_USER_CONFIG_OPTIONS, page_data);
+
+    if ((STATUS_OK == status) &&
+        (0 != memcmp(debounceConfig, &page_data[EEPROM_INDEX_DEBOUNCE_CONFIG], EEPROM_BYTES_DEBOUNCE_CONFIG)))
+    {
+        memcpy(&page_data[EEPROM_INDEX_DEBOUNCE_CONFIG], debounceConfig, EEPROM_BYTES_DEBOUNCE_CONFIG);
+        status = eeprom_emulator_write_page(EEPROM_PAGE_USER_CONFIG_OPTIONS, page_data);
+
+        if (STATUS_OK == status)
+        {
+            status = eeprom_emulator_commit_page_buffer();
+        }
+    }
+    return status;
+}
@@ -23,7 +23,14 @@
 #define MODEL_VERSION_SIZE               9
 #define HARDWARE_VERSION_SIZE            7
 #define FIRMWARE_VERSION_SIZE            7
-#define EEPROM_BYTES_USER_CONFIG_OPTIONS 32
+#define EEPROM_BYTES_USER_CONFIG_OPTIONS 32   // User config page bytes 00-31 (Volume, Alarms, Latch State)
+
+// Debounce config, user config page bytes 32-50 after the user config options
+#define EEPROM_BYTES_DEBOUNCE_CONFIG           19
+#define DEBOUNCE_CONFIG_INDEX_MAGIC            0
+#define DEBOUNCE_CONFIG_INDEX_PROFILES         1   // 01-12, 4 profiles x lift/press/qualify
+#define DEBOUNCE_CONFIG_INDEX_CHANNEL_PROFILES 13  // 13-18, profile per channel, 2 channels per byte
+#define DEBOUNCE_CONFIG_MAGIC                  0xD5
 
 enum modelType_t
 {
@@ -83,4 +90,8 @@ void app_eeprom_write_modelType(uint8_t ul_modelType);
 void app_eeprom_read_userConfig(uint8_t *userConfig);
 void app_eeprom_write_userConfig(uint8_t *userConfiguration);
 
+// Debounce Config
+enum status_code app_eeprom_read_debounceConfig(uint8_t *debounceConfig);
+enum status_code app_eeprom_write_debounceConfig(const uint8_t *debounceConfig);
+
 #endif /* APP_EEPROM_H_ */
@@ -7,11 +7,16 @@
 
 
 #include <asf.h>
+#include <string.h>
 #include "app_gen_io.h"
 #include "app_arm.h"
 #include "app_bbu.h"
 #include "app_buzzer.h"
+#include "app_daisychain.h"
+#include "app_eeprom.h"
+#include "app_timers.h"
 #include "app_uart.h"
+#include "hw_timer.h"
 #include "slpTimer.h"
 #include "sysTimer.h"
 
@@ -19,31 +24,92 @@
 #define BATTERY_LEVEL_STORAGE (3900)
 #define BATTERY_LEVEL_DEAD    (3000)
 
+// #define ENABLE_GENIO_DEBUG_MSGS 1 // Uncomment to print out Debug messages
+
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
 //      VARIABLES
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
 
-volatile AlarmModuleStatus_t amStatus;
+// Module state, one aligned byte per flag so the ISR and the main loop never
+// read-modify-write a shared bitfield word. Packed by app_gen_io_get_AM_status().
+typedef struct AlarmModuleState_t
+{
+    volatile uint8_t isMaster;
+    volatile uint8_t Powered;
+    volatile uint8_t notCharging;
+    volatile uint8_t deepSleep;
+    volatile uint8_t shutDown;
+    volatile uint8_t switchLifted;
+} AlarmModuleState_t;
+
+static AlarmModuleState_t amStatus;
 volatile bool ShelfStorageMessageSent;                           // Over debug? 
 
-static SYS_Timer_t debouncePowerGoodTimer;
-static SYS_Timer_t debounce_nMASTERTimer; 
-static SLP_Timer_t shelfStorageConditionTimer;
-static SYS_Timer_t debounceCh_00_SwitchTimer;
-static SYS_Timer_t debounceCh_01_SwitchTimer;
-static SYS_Timer_t debounceCh_02_SwitchTimer;
-static SYS_Timer_t debounceCh_03_SwitchTimer;
-static SYS_Timer_t debounceCh_04_SwitchTimer;
-static SYS_Timer_t debounceCh_05_SwitchTimer;
-static SYS_Timer_t debounceCh_06_SwitchTimer;
-static SYS_Timer_t debounceCh_07_SwitchTimer;
-static SYS_Timer_t debounceCh_08_SwitchTimer;
-static SYS_Timer_t debounceCh_09_SwitchTimer;
-static SYS_Timer_t debounceCh_10_SwitchTimer;
-static SYS_Timer_t debounceCh_11_SwitchTimer;
-static SYS_Timer_t debounce_nDISARM_Timer;
+// Bit-sliced switch debounce, one bit per channel at its PORT A pin position
+#define PORTA_PIN_MASK(pin)     (1ul << ((pin) % 32))
+#define CHANNEL_PIN_MASK(num)   PORTA_PIN_MASK(Channel[num].gpio_pin)
+
+static uint32_t channelPinMask;                                 // All channel pins
+static uint32_t debounceState;                                  // Debounced pin levels, 1 = open
+static uint32_t debounceCnt0;                                   // Vertical counter, bit 0
+static uint32_t debounceCnt1;                                   // Vertical counter, bit 1
+static volatile bool debounceEdge;                              // Edge seen since the last sample
+
+static uint8_t eicLineToChannel[EIC_NUMBER_OF_INTERRUPTS];      // EIC line -> channel, CH_NONE if unused
+static volatile uint16_t channelEdges[CH_COUNT];                // Edge interrupts per channel
+static uint16_t channelTransitions[CH_COUNT];                   // Debounced transitions per channel
+
+// Channel EIC filter, switchable at run time so a unit can be compared with it off and on
+static bool inputFilter;                                        // FILTEN set on the channel lines
+static InputFilterStats_t inputFilterStats[2];                  // [inputFilter], every channel together
+static uint32_t inputFilterSince;                               // ms, inputFilter last changed
+
+// Edge ring, single producer (channel interrupt) and single consumer (debounce sampler).
+// Only channel edges go in, power good, nDISARM and the daisy chain ARM line keep their
+// own debounce timers and nothing reads their edge times.
+// Indexes run free and wrap at 256, EDGE_RING_SIZE divides that.
+static ChannelEdge_t edgeRing[EDGE_RING_SIZE];
+static volatile uint8_t edgeRingHead;                           // Written by the interrupt only
+static volatile uint8_t edgeRingTail;                           // Written by the consumer only
+static volatile uint16_t edgeRingOverflows;                     // Edges dropped on a full ring
+
+static uint16_t edgePending;                                    // Channels with a transition in progress
+#ifdef SYS_TIMER_PROFILE
+static ChannelIsrProfile_t channelIsrProfile;
+#endif
+static ChannelTiming_t channelTiming[CH_COUNT];
+
+// Debounce profiles. A filtered level that differs from the reported state is held
+// for the profile time before it is reported, an open armed port is held for the
+// qualify time before it alarms.
+static DebounceProfile_t debounceProfiles[DEBOUNCE_PROFILE_COUNT];
+static uint8_t channelProfile[CH_COUNT];
+static uint16_t debounceHold;                                   // Channels waiting out lift/press time
+static uint16_t alarmQualify;                                   // Armed channels waiting out qualify time
+static uint32_t debounceHoldStart[CH_COUNT];                    // ms
+static uint32_t alarmQualifyStart[CH_COUNT];                    // ms
+
+// Channel state, one bit per channel. Read without locking, changed in a critical section.
+static volatile uint16_t channelPresent;                        // Cable present (switch closed)
+static volatile uint16_t channelArmed;
+static volatile uint16_t channelAlarming;
+static volatile uint16_t channelFault;                          // Quarantined for chatter, EIC line masked
+static volatile uint16_t channelDirty;                          // Reported a transition since the last take
+
+// Chatter accounting
+static uint32_t chatterWindowStart[CH_COUNT];                   // ms, start of the current edge count window
+static uint8_t  chatterWindowEdges[CH_COUNT];                   // Edges in the current window
+static uint8_t  chatterStablePolls[CH_COUNT];                   // Polls at the same level while quarantined
+static uint16_t chatterLevel;                                   // Last polled level of quarantined channels
+static uint16_t channelQuarantines[CH_COUNT];                   // Times each channel was quarantined
+
+static uint16_t snapshotSequence;
+
+static volatile bool bootReady;                                 // Boot inputs sampled, interrupts running
+static uint32_t bootStartUs;                                    // main() before SYS_TimerInit(), app_gen_io_set_boot_start_us()
+static uint32_t bootReadyUs;                                    // Start of main() to bootReady
 
 
 // ----------------------------------------------------------------------------------------
@@ -55,54 +121,60 @@ static SYS_Timer_t debounce_nDISARM_Timer;
 void app_gen_io_init_cables(void);
 static void extint_callback_power_good(void);
 // static void exting_callback_nMASTER(void);           // Read on boot and power loss, don't need Interrupt
-static void extint_callback_debounceCh_00(void);
-static void extint_callback_debounceCh_01(void);
-static void extint_callback_debounceCh_02(void);
-static void extint_callback_debounceCh_03(void);
-static void extint_callback_debounceCh_04(void);
-static void extint_callback_debounceCh_05(void);
-static void extint_callback_debounceCh_06(void);
-static void extint_callback_debounceCh_07(void);
-static void extint_callback_debounceCh_08(void);
-static void extint_callback_debounceCh_09(void);
-static void extint_callback_debounceCh_10(void);
-static void extint_callback_debounceCh_11(void);
+static void extint_callback_channel(void);
+static void channelInterrupt(void);
+static void channelEicConfig(uint8_t num);
 static void extint_callback_debounce_nDISARM(void);
 
 
-static void shelfStorageConditionTimerHandler(SLP_Timer_t *timer);
-static void debouncePowerGoodTimerHandler(SYS_Timer_t *timer);
-static void debounce_nMASTERTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_00_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_01_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_02_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_03_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_04_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_05_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_06_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_07_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_08_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_09_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_10_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounceCh_11_SwitchTimerHandler(SYS_Timer_t *timer);
-static void debounce_nDISARM_TimerHandler(SYS_Timer_t *timer);
-
-
-struct ChannelStatus_t Channel[CH_COUNT] = 
-{
-    //   gpio_pin,      gpio_eic_mux,      gpio_eic_line,  timer,                     timerHandler_function,        PortStatus
-    {CHANNEL_0_PIN, CHANNEL_0_EIC_MUX, CHANNEL_0_EIC_LINE, &debounceCh_00_SwitchTimer, debounceCh_00_SwitchTimerHandler, 0},
-    {CHANNEL_1_PIN, CHANNEL_1_EIC_MUX, CHANNEL_1_EIC_LINE, &debounceCh_01_SwitchTimer, debounceCh_01_SwitchTimerHandler, 0},
-    {CHANNEL_2_PIN, CHANNEL_2_EIC_MUX, CHANNEL_2_EIC_LINE, &debounceCh_02_SwitchTimer, debounceCh_02_SwitchTimerHandler, 0},
-    {CHANNEL_3_PIN, CHANNEL_3_EIC_MUX, CHANNEL_3_EIC_LINE, &debounceCh_03_SwitchTimer, debounceCh_03_SwitchTimerHandler, 0},
-    {CHANNEL_4_PIN, CHANNEL_4_EIC_MUX, CHANNEL_4_EIC_LINE, &debounceCh_04_SwitchTimer, debounceCh_04_SwitchTimerHandler, 0},
-    {CHANNEL_5_PIN, CHANNEL_5_EIC_MUX, CHANNEL_5_EIC_LINE, &debounceCh_05_SwitchTimer, debounceCh_05_SwitchTimerHandler, 0},
-    {CHANNEL_6_PIN, CHANNEL_6_EIC_MUX, CHANNEL_6_EIC_LINE, &debounceCh_06_SwitchTimer, debounceCh_06_SwitchTimerHandler, 0},
-    {CHANNEL_7_PIN, CHANNEL_7_EIC_MUX, CHANNEL_7_EIC_LINE, &debounceCh_07_SwitchTimer, debounceCh_07_SwitchTimerHandler, 0},
-    {CHANNEL_8_PIN, CHANNEL_8_EIC_MUX, CHANNEL_8_EIC_LINE, &debounceCh_08_SwitchTimer, debounceCh_08_SwitchTimerHandler, 0},
-    {CHANNEL_9_PIN, CHANNEL_9_EIC_MUX, CHANNEL_9_EIC_LINE, &debounceCh_09_SwitchTimer, debounceCh_09_SwitchTimerHandler, 0},
-    {CHANNEL_10_PIN, CHANNEL_10_EIC_MUX, CHANNEL_10_EIC_LINE, &debounceCh_10_SwitchTimer, debounceCh_10_SwitchTimerHandler, 0},
-    {CHANNEL_11_PIN, CHANNEL_11_EIC_MUX, CHANNEL_11_EIC_LINE, &debounceCh_11_SwitchTimer, debounceCh_11_SwitchTimerHandler, 0},
+static void debounceSampleStart(void);
+static bool chatterQuarantine(uint8_t num);
+static void edgeRingPush(uint8_t num);
+static bool edgeRingPop(ChannelEdge_t *edge);
+static void edgeRingDrain(void);
+static void debounceProfilesLoad(void);
+static enum status_code debounceProfilesSave(void);
+static void channelDebounceHold(uint8_t num, uint32_t now);
+static void channelAlarm(uint8_t num);
+static void channelSwitchChanged(uint8_t num, bool open);
+
+const ChannelStatus_t Channel[CH_COUNT] = 
+{
+    //   gpio_pin,      gpio_eic_mux,      gpio_eic_line
+    {CHANNEL_0_PIN, CHANNEL_0_EIC_MUX, CHANNEL_0_EIC_LINE},
+#if CH_COUNT > 1
+    {CHANNEL_1_PIN, CHANNEL_1_EIC_MUX, CHANNEL_1_EIC_LINE},
+#endif
+#if CH_COUNT > 2
+    {CHANNEL_2_PIN, CHANNEL_2_EIC_MUX, CHANNEL_2_EIC_LINE},
+#endif
+#if CH_COUNT > 3
+    {CHANNEL_3_PIN, CHANNEL_3_EIC_MUX, CHANNEL_3_EIC_LINE},
+#endif
+#if CH_COUNT > 4
+    {CHANNEL_4_PIN, CHANNEL_4_EIC_MUX, CHANNEL_4_EIC_LINE},
+#endif
+#if CH_COUNT > 5
+    {CHANNEL_5_PIN, CHANNEL_5_EIC_MUX, CHANNEL_5_EIC_LINE},
+#endif
+#if CH_COUNT > 6
+    {CHANNEL_6_PIN, CHANNEL_6_EIC_MUX, CHANNEL_6_EIC_LINE},
+#endif
+#if CH_COUNT > 7
+    {CHANNEL_7_PIN, CHANNEL_7_EIC_MUX, CHANNEL_7_EIC_LINE},
+#endif
+#if CH_COUNT > 8
+    {CHANNEL_8_PIN, CHANNEL_8_EIC_MUX, CHANNEL_8_EIC_LINE},
+#endif
+#if CH_COUNT > 9
+    {CHANNEL_9_PIN, CHANNEL_9_EIC_MUX, CHANNEL_9_EIC_LINE},
+#endif
+#if CH_COUNT > 10
+    {CHANNEL_10_PIN, CHANNEL_10_EIC_MUX, CHANNEL_10_EIC_LINE},
+#endif
+#if CH_COUNT > 11
+    {CHANNEL_11_PIN, CHANNEL_11_EIC_MUX, CHANNEL_11_EIC_LINE},
+#endif
 };
 
 // ----------------------------------------------------------------------------------------
@@ -123,55 +195,36 @@ void app_gen_io_init(void)
     
     port_get_config_defaults(&pin_conf);                            // Re-fetch defaults
     
-    app_gen_io_init_cables(); // Configure cables as Input Pull-None and read logic level to determine cable status
+    bootReady = false;
+    debounceProfilesLoad();
+    app_gen_io_init_cables(); // Configure cables as Input Pull-None, they are sampled once the inputs settle
     
     struct extint_chan_conf config_extint_chan;
     extint_chan_get_config_defaults(&config_extint_chan);
 
-    debouncePowerGoodTimer.interval = STANDARD_DEBOUNCE_INTERVAL_MS;  // delay
-    debouncePowerGoodTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-    debouncePowerGoodTimer.handler  = debouncePowerGoodTimerHandler;
-    
-    debounce_nMASTERTimer.interval = STANDARD_DEBOUNCE_INTERVAL_MS;  // delay
-    debounce_nMASTERTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-    debounce_nMASTERTimer.handler  = debounce_nMASTERTimerHandler;
-    
-    shelfStorageConditionTimer.interval = SHELF_STORAGE_MESSAGE_INTERVAL_MS;  // delay
-    shelfStorageConditionTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-    shelfStorageConditionTimer.handler  = shelfStorageConditionTimerHandler;
-    
-    debounce_nDISARM_Timer.interval = STANDARD_DEBOUNCE_INTERVAL_MS;  // delay
-    debounce_nDISARM_Timer.mode     = SYS_TIMER_INTERVAL_MODE;
-    debounce_nDISARM_Timer.handler  = debounce_nDISARM_TimerHandler;
-
-    for(int num; num < CH_COUNT; num++)
-    {
-        Channel[num].timer->interval = STANDARD_DEBOUNCE_INTERVAL_MS;  // delay
-        Channel[num].timer->mode     = SYS_TIMER_INTERVAL_MODE;
-        Channel[num].timer->handler  = Channel[num].timerHandler;
-    }
-
     // Setup Power Good input. Be sure NOT to have the pull-up enabled,
     // as it's stronger than the lower resistor in the divider.
     config_extint_chan.gpio_pin           = POWER_GOOD_EIC_PIN;
     config_extint_chan.gpio_pin_mux       = POWER_GOOD_EIC_MUX;
     config_extint_chan.gpio_pin_pull      = EXTINT_PULL_NONE;  // <<<===
     config_extint_chan.detection_criteria = EXTINT_DETECT_BOTH;
+    config_extint_chan.filter_input_signal = EIC_INPUT_FILTER;
     extint_chan_set_config(POWER_GOOD_EIC_LINE, &config_extint_chan);
 
     config_extint_chan.gpio_pin           = nDISARM_PIN;
     config_extint_chan.gpio_pin_mux       = nDISARM_EIC_MUX;
     config_extint_chan.gpio_pin_pull      = EXTINT_PULL_NONE;  // <<<===
     config_extint_chan.detection_criteria = EXTINT_DETECT_BOTH;
+    config_extint_chan.filter_input_signal = EIC_INPUT_FILTER;
     extint_chan_set_config(nDISARM_EIC_LINE, &config_extint_chan);
 
+    inputFilter      = EIC_INPUT_FILTER;
+    inputFilterSince = SYS_Timer_Time();
+    memset(inputFilterStats, 0, sizeof(inputFilterStats));
+    
     for(int num = 0; num < CH_COUNT; num++)
     {
-        config_extint_chan.gpio_pin           = Channel[num].gpio_pin;
-        config_extint_chan.gpio_pin_mux       = Channel[num].gpio_eic_mux;
-        config_extint_chan.gpio_pin_pull      = EXTINT_PULL_UP;
-        config_extint_chan.detection_criteria = EXTINT_DETECT_BOTH;
-        extint_chan_set_config(Channel[num].gpio_eic_line, &config_extint_chan);
+        channelEicConfig(num);
     }
 
     pin_conf.direction  = PORT_PIN_DIR_INPUT;
@@ -183,10 +236,56 @@ void app_gen_io_init(void)
     port_pin_set_config(BAT_MON_PIN, &pin_conf);        // Input Pull-None
    // port_pin_set_config(nDISARM_PIN, &pin_conf);   // Input Pull-None
     
-    // Delay to allow hardware debounce components to stabilize after configuration
-    delay_cycles_ms(100);
+    // Setup default Status'
+    amStatus.deepSleep = false;
+    amStatus.shutDown  = false;
+    amStatus.switchLifted    = false;
+    
+    extint_register_callback(extint_callback_power_good, POWER_GOOD_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
+    
+    edgeRingHead = 0;
+    edgeRingTail = 0;
+    edgePending  = 0;
+    
+    extint_register_callback(extint_callback_debounce_nDISARM, nDISARM_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
+    extint_chan_enable_callback(nDISARM_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
+    
+    // Setup Cable interrupts, every channel line shares one dispatcher
+    for (int line = 0; line < EIC_NUMBER_OF_INTERRUPTS; line++)
+    {
+        eicLineToChannel[line] = CH_NONE;
+    }
+    
+    for (int num = 0; num < CH_COUNT; num++)
+    {
+        eicLineToChannel[Channel[num].gpio_eic_line] = num;
+        extint_register_callback(extint_callback_channel, Channel[num].gpio_eic_line, EXTINT_CALLBACK_TYPE_DETECT);
+    }
+    
+    // Set up analog input pins
+    pin_conf.input_pull = PORT_PIN_PULL_NONE;
+    port_pin_set_config(BAT_MON_PIN, &pin_conf);
+    
+    ShelfStorageMessageSent = false;
+    
+    // The rest of the system initializes while the inputs settle, the power good and
+    // channel interrupts are enabled once they have been sampled.
+    SYS_TimerStart(APP_TIMER(GEN_IO_BOOT_SETTLE));
+}
+
+
+// Inputs have settled since app_gen_io_init(). Takes the power good, nMASTER and
+// every channel level from one PORT read and starts watching them.
+void bootSettleTimerHandler(SYS_Timer_t *timer)
+{
+    uint32_t pins;
+    
+    UNUSED(timer);
+    
+    pins = port_group_get_input_level(&PORT->Group[0],
+                                      channelPinMask | PORTA_PIN_MASK(POWER_GOOD_PIN) | PORTA_PIN_MASK(nMASTER_PIN));
     
-    if (port_pin_get_input_level(POWER_GOOD_PIN))  // High = Power Good, Low = No Power
+    if(pins & PORTA_PIN_MASK(POWER_GOOD_PIN))  // High = Power Good, Low = No Power
     {
         amStatus.notCharging = false;
         amStatus.Powered  = POWER_GOOD;
@@ -197,12 +296,10 @@ void app_gen_io_init(void)
         amStatus.Powered  = POWER_NOT_GOOD;
     }
     
-    // Setup default Status'
-    amStatus.deepSleep = false;
-    amStatus.shutDown  = false;
-    amStatus.switchLifted    = false;
-        
-    if( port_pin_get_input_level(nMASTER_PIN) )
+    app_arm_set_not_ready(ARM_NOT_READY_NO_POWER, (POWER_NOT_GOOD == amStatus.Powered));
+    app_arm_set_not_ready(ARM_NOT_READY_nDISARM, (port_pin_get_input_level(nDISARM_PIN) != CAN_ARM));
+    
+    if(pins & PORTA_PIN_MASK(nMASTER_PIN))
     {
         // HIGH - Not Master AM - This unit will be a slave AM
         amStatus.isMaster = AM_NOT_MASTER;
@@ -216,38 +313,53 @@ void app_gen_io_init(void)
         app_arm_set_PowerTamper_armed(SYSTEM_ARMED);
         app_arm_clear_PowerTamper_alarm();
     }
-
-    extint_register_callback(extint_callback_power_good, POWER_GOOD_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_chan_enable_callback(POWER_GOOD_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
     
-    extint_register_callback(extint_callback_debounce_nDISARM, nDISARM_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_chan_enable_callback(nDISARM_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
+    // Open (high) channels start debounced open, closed ones present
+    debounceState  = pins & channelPinMask;
+    channelPresent = 0;
     
-    // Setup Cable interrupts
-    extint_register_callback(extint_callback_debounceCh_00, CHANNEL_0_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_01, CHANNEL_1_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_02, CHANNEL_2_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_03, CHANNEL_3_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_04, CHANNEL_4_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_05, CHANNEL_5_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_06, CHANNEL_6_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_07, CHANNEL_7_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_08, CHANNEL_8_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_09, CHANNEL_9_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_10, CHANNEL_10_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_register_callback(extint_callback_debounceCh_11, CHANNEL_11_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    
-    for (int num; num < CH_COUNT; num++)
+    for(int num = 0; num < CH_COUNT; num++)
     {
-        extint_chan_enable_callback(Channel[num].gpio_eic_line, EXTINT_CALLBACK_TYPE_DETECT);  
+        if( !(debounceState & CHANNEL_PIN_MASK(num)) )
+        {
+            channelPresent |= CH_MASK(num);
+        }
     }
     
-    // Set up analog input pins
-    pin_conf.input_pull = PORT_PIN_PULL_NONE;
-    port_pin_set_config(BAT_MON_PIN, &pin_conf);
+    extint_chan_enable_callback(POWER_GOOD_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
     
-    ShelfStorageMessageSent = false;
+    for(int num = 0; num < CH_COUNT; num++)
+    {
+        extint_chan_clear_detected(Channel[num].gpio_eic_line);
+        extint_chan_enable_callback(Channel[num].gpio_eic_line, EXTINT_CALLBACK_TYPE_DETECT);
+    }
+    
+    // The daisy chain role comes from nMASTER
+    app_daisychain_init();
+    
+    bootReadyUs = bootStartUs + (uint32_t)SYS_Timer_TimeUs();
+    bootReady   = true;
+    app_arm_set_not_ready(ARM_NOT_READY_BOOTING, false);
+    #ifdef ENABLE_GENIO_DEBUG_MSGS
+    UART_DBG_TX("\nBOOT: ready in %lu us\n", (unsigned long)bootReadyUs);
+    #endif
+    
+    // Cables are known now, auto-arm can run from here
+    app_arm_reset_auto_arm_timer();
+}
+
+
+static void channelEicConfig(uint8_t num)
+{
+    struct extint_chan_conf config_extint_chan;
+    extint_chan_get_config_defaults(&config_extint_chan);
     
+    config_extint_chan.gpio_pin           = Channel[num].gpio_pin;
+    config_extint_chan.gpio_pin_mux       = Channel[num].gpio_eic_mux;
+    config_extint_chan.gpio_pin_pull      = EXTINT_PULL_UP;
+    config_extint_chan.detection_criteria = EXTINT_DETECT_BOTH;
+    config_extint_chan.filter_input_signal = inputFilter;
+    extint_chan_set_config(Channel[num].gpio_eic_line, &config_extint_chan);
 }
 
 
@@ -257,27 +369,24 @@ void app_gen_io_init_cables(void)
     port_get_config_defaults(&pin_conf);
     pin_conf.input_pull = PORT_PIN_PULL_NONE;
     
-    for(int num; num < CH_COUNT; num++)
+    for(int num = 0; num < CH_COUNT; num++)
     {
         port_pin_set_config(Channel[num].gpio_pin, &pin_conf);  // Inputs with no pull
     }        
     
-    delay_cycles_ms(100);                                       // Allow pins to stabilize
+    channelPinMask = 0;
+    debounceState  = 0;
+    debounceCnt0   = 0;
+    debounceCnt1   = 0;
+    
+    channelPresent  = 0;
+    channelArmed    = 0;
+    channelAlarming = 0;
+    channelFault    = 0;
     
-    for(int num; num < CH_COUNT; num++)
+    for(int num = 0; num < CH_COUNT; num++)
     {
-        // Read value and assign
-        if(port_pin_get_input_level(Channel[num].gpio_pin) == LOW)
-        {
-            Channel[num].portStat.cablePresent = CABLE_PRESENT;
-        }
-        else
-        {
-            Channel[num].portStat.cablePresent = CABLE_ABSENT; 
-        }
-        
-        Channel[num].portStat.armed = PORT_DISARMED;
-        Channel[num].portStat.alarming = PORT_NOT_ALARMING;
+        channelPinMask |= CHANNEL_PIN_MASK(num);
     }   
 }
 
@@ -303,14 +412,14 @@ void app_gen_io_kill_switch_task(void)
     //                     // handled in
     //                     puckStatus.shutDown = true;
     //
-    //                     if ((!SLP_TimerStarted(&shelfStorageConditionTimer)) && (ShelfStorageMessageSent == false))
+    //                     if ((!SLP_TimerStarted(APP_TIMER(GEN_IO_SHELF_STORAGE))) && (ShelfStorageMessageSent == false))
     //                     {
     //                         // Send the lwmesh message only once
     //                         ShelfStorageMessageSent = true;
     //                         app_lwmesh_send_status();
     //                     }
     //
-    //                     SLP_TimerStart(&shelfStorageConditionTimer);
+    //                     SLP_TimerStart(APP_TIMER(GEN_IO_SHELF_STORAGE));
     //                 }
     //             }
     //         }
@@ -332,99 +441,168 @@ void app_gen_io_set_status_deepSleep(uint16_t sleepState)
 static void extint_callback_power_good(void)  // Power Good indicator - now just a voltage divider
 {
     app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debouncePowerGoodTimer);
+    SYS_TimerRestart(APP_TIMER(GEN_IO_POWER_GOOD));
     amStatus.Powered = POWER_NOT_GOOD;
+    app_arm_set_not_ready(ARM_NOT_READY_NO_POWER, true);
 }
 
 
-static void extint_callback_debounceCh_00(void)
-{
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_00_SwitchTimer);
-}
-
-
-static void extint_callback_debounceCh_01(void)
-{
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_01_SwitchTimer);
-}
-
-
-static void extint_callback_debounceCh_02(void)
-{
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_02_SwitchTimer);
-}
-
-
-static void extint_callback_debounceCh_03(void)
-{
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_03_SwitchTimer);
-}
-
-
-static void extint_callback_debounceCh_04(void)
+static void extint_callback_channel(void)
 {
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_04_SwitchTimer);
-}
-
-
-static void extint_callback_debounceCh_05(void)
-{
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_05_SwitchTimer);
+#ifdef SYS_TIMER_PROFILE
+    // Each count read waits for a TC3 sync, so this only runs when profiling
+    uint16_t start = hw_timer_get_count();
+    uint16_t counts;
+    
+    channelInterrupt();
+    
+    counts = hw_timer_get_count() - start;
+    channelIsrProfile.runs++;
+    channelIsrProfile.totalCounts += counts;
+    if(counts > channelIsrProfile.maxCounts)
+    {
+        channelIsrProfile.maxCounts = counts;
+    }
+#else
+    channelInterrupt();
+#endif
 }
 
 
-static void extint_callback_debounceCh_06(void)
+static void channelInterrupt(void)
 {
+    uint8_t num = eicLineToChannel[extint_get_current_channel()];
+    
+    if(CH_NONE == num)
+    {
+        return;
+    }
+    
+    channelEdges[num]++;
+    inputFilterStats[inputFilter].edges++;
+    edgeRingPush(num);
+    
+    if(chatterQuarantine(num))
+    {
+        // Line is masked now, the poll timer takes over from interrupt. Don't keep the MCU
+        // awake for it, the poll wakes the main loop when the level actually changes.
+        return;
+    }
+    
     app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_06_SwitchTimer);
+    debounceSampleStart();
 }
 
 
-static void extint_callback_debounceCh_07(void)
+// Edge rate accounting, called from the channel interrupt. A channel that exceeds
+// CHATTER_EDGE_LIMIT edges in CHATTER_WINDOW_MS has its EIC line masked and is
+// flagged as faulted, so one bad cable can't starve the main loop or keep us awake.
+static bool chatterQuarantine(uint8_t num)
 {
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_07_SwitchTimer);
+    uint32_t now = SYS_Timer_Time();
+    
+    if((now - chatterWindowStart[num]) >= CHATTER_WINDOW_MS)
+    {
+        chatterWindowStart[num] = now;
+        chatterWindowEdges[num] = 0;
+    }
+    
+    if(++chatterWindowEdges[num] <= CHATTER_EDGE_LIMIT)
+    {
+        return false;
+    }
+    
+    extint_chan_disable_callback(Channel[num].gpio_eic_line, EXTINT_CALLBACK_TYPE_DETECT);
+    
+    channelFault |= CH_MASK(num);
+    channelQuarantines[num]++;
+    chatterStablePolls[num] = 0;
+    chatterWindowEdges[num] = 0;
+    
+    SLP_TimerStart(APP_TIMER(GEN_IO_CHATTER_POLL));
+    return true;
 }
 
 
-static void extint_callback_debounceCh_08(void)
+// Called from the channel interrupt. The entry is written before the head moves,
+// so the consumer never sees a half written edge.
+static void edgeRingPush(uint8_t num)
 {
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_08_SwitchTimer);
+    uint8_t head = edgeRingHead;
+    ChannelEdge_t *edge;
+    
+    if((uint8_t)(head - edgeRingTail) >= EDGE_RING_SIZE)
+    {
+        edgeRingOverflows++;
+        return;
+    }
+    
+    edge = &edgeRing[head & (EDGE_RING_SIZE - 1)];
+    edge->timeUs = (uint32_t)SYS_Timer_TimeUs();
+    edge->line   = Channel[num].gpio_eic_line;
+    edge->level  = port_pin_get_input_level(Channel[num].gpio_pin);
+    
+    barrier();
+    edgeRingHead = head + 1;
 }
 
 
-static void extint_callback_debounceCh_09(void)
+static bool edgeRingPop(ChannelEdge_t *edge)
 {
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_09_SwitchTimer);
+    uint8_t tail = edgeRingTail;
+    
+    if(tail == edgeRingHead)
+    {
+        return false;
+    }
+    
+    barrier();
+    *edge = edgeRing[tail & (EDGE_RING_SIZE - 1)];
+    edgeRingTail = tail + 1;
+    return true;
 }
 
 
-static void extint_callback_debounceCh_10(void)
+// Folds the captured edges into the per-channel transition timing. The first edge
+// away from the debounced level starts a transition, later edges extend its bounce.
+static void edgeRingDrain(void)
 {
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_10_SwitchTimer);
+    ChannelEdge_t edge;
+    
+    while(edgeRingPop(&edge))
+    {
+        uint8_t num = eicLineToChannel[edge.line];
+        uint16_t bit = CH_MASK(num);
+        
+        
+        if(edgePending & bit)
+        {
+            channelTiming[num].bounceUs = edge.timeUs - channelTiming[num].edgeUs;
+            channelTiming[num].bounceEdges++;
+        }
+        else if(((debounceState & CHANNEL_PIN_MASK(num)) != 0) != (edge.level != 0))
+        {
+            edgePending |= bit;
+            channelTiming[num].edgeUs      = edge.timeUs;
+            channelTiming[num].bounceUs    = 0;
+            channelTiming[num].bounceEdges = 1;
+        }
+    }
 }
 
 
-static void extint_callback_debounceCh_11(void)
+static void debounceSampleStart(void)
 {
-    app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounceCh_11_SwitchTimer);
+    // Already sampling is fine, the edge just keeps the sample timer running
+    debounceEdge = true;
+    SYS_TimerStart(APP_TIMER(GEN_IO_DEBOUNCE_SAMPLE));
 }
 
 
 static void extint_callback_debounce_nDISARM(void)
 {
     app_bbu_sleep_on_exit(false);
-    SYS_TimerRestart(&debounce_nDISARM_Timer);
+    SYS_TimerRestart(APP_TIMER(GEN_IO_nDISARM));
 }
 
 // ----------------------------------------------------------------------------------------
@@ -433,7 +611,7 @@ static void extint_callback_debounce_nDISARM(void)
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
 
-static void shelfStorageConditionTimerHandler(SLP_Timer_t *timer)
+void shelfStorageConditionTimerHandler(SLP_Timer_t *timer)
 {
     UNUSED(timer);
     #ifdef ENABLE_GENIO_DEBUG_MSGS
@@ -444,7 +622,7 @@ static void shelfStorageConditionTimerHandler(SLP_Timer_t *timer)
 
 
 
-static void debouncePowerGoodTimerHandler(SYS_Timer_t *timer)
+void debouncePowerGoodTimerHandler(SYS_Timer_t *timer)
 {
     UNUSED(timer);
 
@@ -452,7 +630,8 @@ static void debouncePowerGoodTimerHandler(SYS_Timer_t *timer)
     {
         amStatus.Powered = POWER_GOOD;
         amStatus.shutDown   = false;
-        SLP_TimerStop(&shelfStorageConditionTimer);  // Don't issue kill command
+        app_arm_set_not_ready(ARM_NOT_READY_NO_POWER, false);
+        SLP_TimerStop(APP_TIMER(GEN_IO_SHELF_STORAGE));  // Don't issue kill command
         app_arm_reset_auto_arm_timer();
         app_buzzer_stop_pattern(BUZ_PAT_PUCK_DEEP_SLEEP);
         
@@ -471,11 +650,12 @@ static void debouncePowerGoodTimerHandler(SYS_Timer_t *timer)
     else
     {
         amStatus.Powered = POWER_NOT_GOOD;
+        app_arm_set_not_ready(ARM_NOT_READY_NO_POWER, true);
         if( (AM_IS_MASTER == amStatus.isMaster) && (SYSTEM_ARMED == app_arm_get_system_armed() ) )
         {
             // Power Tamper Alarm is only on the Master Unit & Only if a Channel is armed
             // Check nMASTER if its gone high with the power loss we might alarm.  
-            SYS_TimerStart(&debounce_nMASTERTimer);   
+            SYS_TimerStart(APP_TIMER(GEN_IO_nMASTER));   
         }
     }
 
@@ -483,7 +663,7 @@ static void debouncePowerGoodTimerHandler(SYS_Timer_t *timer)
 }
 
 
-static void debounce_nMASTERTimerHandler(SYS_Timer_t *timer)
+void debounce_nMASTERTimerHandler(SYS_Timer_t *timer)
 {
     UNUSED(timer);
     
@@ -495,382 +675,249 @@ static void debounce_nMASTERTimerHandler(SYS_Timer_t *timer)
 }
 
 
-static void debounceCh_00_SwitchTimerHandler(SYS_Timer_t *timer)
+// Slow polling of quarantined channels, from the hw timer interrupt so it keeps going
+// while the BBU sleeps on exit. A level change is still handed to the debounce sampler,
+// so a lift is reported while quarantined, just without the interrupt storm.
+void chatterPollTimerHandler(SLP_Timer_t *timer)
 {
-    UNUSED(timer);
+    uint16_t quarantined = channelFault;
     
-    if (port_pin_get_input_level(CHANNEL_0_PIN))
+    for(int num = 0; num < CH_COUNT; num++)
     {
-        // Primary Switch - High = Open
-        Channel[CH_00].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 0 SWITCH OPENED\n");
+        uint16_t bit = CH_MASK(num);
+        uint16_t level;
         
-        if ( (PORT_ARMED == Channel[CH_00].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_00].portStat.alarming))
+        if(!(quarantined & bit))
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_0_SWITCH_WAS_OPENED);
-            Channel[CH_00].portStat.alarming = PORT_ALARMING;
+            continue;
         }
-    }
-    else
-    {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_00].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 0 SWITCH CLOSED\n");
         
-        app_arm_reset_auto_arm_timer();     
-    }
-}
-
-
-
-static void debounceCh_01_SwitchTimerHandler(SYS_Timer_t *timer)
-{
-    UNUSED(timer);
-    
-    if (port_pin_get_input_level(CHANNEL_1_PIN))
-    {
-        // Primary Switch - High = Open
-        Channel[CH_01].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 1 SWITCH OPENED\n");
+        level = port_pin_get_input_level(Channel[num].gpio_pin) ? bit : 0;
         
-        if ( (PORT_ARMED == Channel[CH_01].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_01].portStat.alarming) )
+        if(level != (chatterLevel & bit))
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_1_SWITCH_WAS_OPENED);
-            Channel[CH_01].portStat.alarming = PORT_ALARMING; 
+            chatterLevel ^= bit;
+            chatterStablePolls[num] = 0;
         }
-    }
-    else
-    {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_01].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 1 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
-    }
-}
-
-
-
-static void debounceCh_02_SwitchTimerHandler(SYS_Timer_t *timer)
-{
-    UNUSED(timer);
-    
-    if (port_pin_get_input_level(CHANNEL_2_PIN))
-    {
-        // Primary Switch - High = Open
-        Channel[CH_02].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 2 SWITCH OPENED\n");
-        
-        if ( (PORT_ARMED == Channel[CH_02].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_02].portStat.alarming) )
+        else if(++chatterStablePolls[num] >= CHATTER_RELEASE_POLLS)
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_2_SWITCH_WAS_OPENED);
-            Channel[CH_02].portStat.alarming = PORT_ALARMING;
+            // Stable again, hand the channel back to its interrupt
+            cpu_irq_enter_critical();
+            channelFault &= ~bit;
+            chatterWindowEdges[num] = 0;
+            extint_chan_clear_detected(Channel[num].gpio_eic_line);
+            extint_chan_enable_callback(Channel[num].gpio_eic_line, EXTINT_CALLBACK_TYPE_DETECT);
+            cpu_irq_leave_critical();
+            
+            UART_DBG_TX("\n CHANNEL %d RELEASED FROM QUARANTINE\n", num);
         }
-    }
-    else
-    {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_02].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 2 SWITCH CLOSED\n");
         
-        app_arm_reset_auto_arm_timer();     
-    }
-}
-
-
-
-static void debounceCh_03_SwitchTimerHandler(SYS_Timer_t *timer)
-{
-    UNUSED(timer);
-    
-    if (port_pin_get_input_level(CHANNEL_3_PIN))
-    {
-        // Primary Switch - High = Open
-        Channel[CH_03].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 3 SWITCH OPENED\n");
-        
-        if ( (PORT_ARMED == Channel[CH_03].portStat.armed)  &&\
-             (PORT_NOT_ALARMING == Channel[CH_03].portStat.alarming) )
+        if(((debounceState & CHANNEL_PIN_MASK(num)) != 0) != (level != 0))
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_3_SWITCH_WAS_OPENED);
-            Channel[CH_03].portStat.alarming = PORT_ALARMING; 
+            // The sampler runs in the main loop
+            app_bbu_sleep_on_exit(false);
+            debounceSampleStart();
         }
     }
-    else
+    
+    if(0 == channelFault)
     {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_03].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 3 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
+        SLP_TimerStop(timer);
     }
 }
 
 
-
-static void debounceCh_04_SwitchTimerHandler(SYS_Timer_t *timer)
+void debounceSampleTimerHandler(SYS_Timer_t *timer)
 {
-    UNUSED(timer);
+    uint32_t sample;
+    uint32_t delta;
+    uint32_t toggle;
+    
+    debounceEdge = false;
+    edgeRingDrain();
+    
+    // One read covers every channel, all channel pins are on PORT A
+    sample = port_group_get_input_level(&PORT->Group[0], channelPinMask);
+    delta  = sample ^ debounceState;
+    
+    // 2 bit vertical counter per channel bit. A bit that differs from the debounced state
+    // counts up on every sample and a bit that agrees is reset, so a channel only toggles
+    // after DEBOUNCE_SAMPLE_COUNT samples in a row at the new level.
+    debounceCnt1 = (debounceCnt1 ^ debounceCnt0) & delta;
+    debounceCnt0 = ~debounceCnt0 & delta;
+    toggle = delta & ~(debounceCnt0 | debounceCnt1);
+    debounceState ^= toggle;
     
-    if (port_pin_get_input_level(CHANNEL_4_PIN))
+    if( toggle || debounceHold || alarmQualify || edgePending )
     {
-        // Primary Switch - High = Open
-        Channel[CH_04].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 4 SWITCH OPENED\n");
+        uint32_t now = SYS_Timer_Time();
         
-        if ( (PORT_ARMED == Channel[CH_04].portStat.armed)  &&\
-             (PORT_NOT_ALARMING == Channel[CH_04].portStat.alarming) )
+        for(int num = 0; num < CH_COUNT; num++)
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_4_SWITCH_WAS_OPENED);
-            Channel[CH_04].portStat.alarming = PORT_ALARMING; 
+            uint16_t bit = CH_MASK(num);
+            
+            if( (toggle & CHANNEL_PIN_MASK(num)) || ((debounceHold | alarmQualify | edgePending) & bit) )
+            {
+                channelDebounceHold(num, now);
+                
+                // A transition whose pin is back at the reported level was only a glitch
+                if( !((delta & CHANNEL_PIN_MASK(num)) || (debounceHold & bit)) )
+                {
+                    edgePending &= ~bit;
+                }
+            }
         }
     }
-    else
+    
+    cpu_irq_enter_critical();
+    if( (0 == (debounceCnt0 | debounceCnt1 | debounceHold | alarmQualify)) && !debounceEdge )
     {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_04].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 4 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
+        // Nothing left to count or time, the next edge interrupt starts sampling again
+        SYS_TimerStop(timer);
     }
+    cpu_irq_leave_critical();
 }
 
 
-
-static void debounceCh_05_SwitchTimerHandler(SYS_Timer_t *timer)
+// Applies the channel's debounce profile to its filtered level. The vertical counter
+// already took DEBOUNCE_FILTER_MS of that time.
+static void channelDebounceHold(uint8_t num, uint32_t now)
 {
-    UNUSED(timer);
+    uint16_t bit = CH_MASK(num);
+    const DebounceProfile_t *profile = &debounceProfiles[channelProfile[num]];
+    bool open = (debounceState & CHANNEL_PIN_MASK(num)) != 0;
+    uint32_t holdMs;
     
-    if (port_pin_get_input_level(CHANNEL_5_PIN))
+    if( open == !(channelPresent & bit) )
     {
-        // Primary Switch - High = Open
-        Channel[CH_05].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 5 SWITCH OPENED\n");
-        
-        if ( (PORT_ARMED == Channel[CH_05].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_05].portStat.alarming) )
-        {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_5_SWITCH_WAS_OPENED);
-            Channel[CH_05].portStat.alarming = PORT_ALARMING; 
-        }
+        // Filtered level is back where it was reported, drop the change
+        debounceHold &= ~bit;
     }
     else
     {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_05].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 5 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
-    }
-}
-
-
-
-static void debounceCh_06_SwitchTimerHandler(SYS_Timer_t *timer)
-{
-    UNUSED(timer);
-    
-    if (port_pin_get_input_level(CHANNEL_6_PIN))
-    {
-        // Primary Switch - High = Open
-        Channel[CH_06].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 6 SWITCH OPENED\n");
-        
-        if ( (PORT_ARMED == Channel[CH_06].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_06].portStat.alarming) )
+        if( !(debounceHold & bit) )
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_6_SWITCH_WAS_OPENED);
-            Channel[CH_06].portStat.alarming = PORT_ALARMING; 
+            debounceHold |= bit;
+            debounceHoldStart[num] = now;
         }
-    }
-    else
-    {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_06].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 6 SWITCH CLOSED\n");
         
-        app_arm_reset_auto_arm_timer();     
-    }
-}
-
-
-
-static void debounceCh_07_SwitchTimerHandler(SYS_Timer_t *timer)
-{
-    UNUSED(timer);
-    
-    if (port_pin_get_input_level(CHANNEL_7_PIN))
-    {
-        // Primary Switch - High = Open
-        Channel[CH_07].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 7 SWITCH OPENED\n");
+        holdMs = (open ? profile->liftTime : profile->pressTime) * DEBOUNCE_PROFILE_UNIT_MS;
+        holdMs = (holdMs > DEBOUNCE_FILTER_MS) ? (holdMs - DEBOUNCE_FILTER_MS) : 0;
         
-        if ( (PORT_ARMED == Channel[CH_07].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_07].portStat.alarming) )
+        if( (now - debounceHoldStart[num]) >= holdMs )
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_7_SWITCH_WAS_OPENED);
-            Channel[CH_07].portStat.alarming = PORT_ALARMING; 
+            debounceHold &= ~bit;
+            channelSwitchChanged(num, open);
         }
     }
-    else
-    {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_07].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 7 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
-    }
-}
-
-
-
-static void debounceCh_08_SwitchTimerHandler(SYS_Timer_t *timer)
-{
-    UNUSED(timer);
     
-    if (port_pin_get_input_level(CHANNEL_8_PIN))
+    if( alarmQualify & bit )
     {
-        // Primary Switch - High = Open
-        Channel[CH_08].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 8 SWITCH OPENED\n");
-        
-        if ( (PORT_ARMED == Channel[CH_08].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_08].portStat.alarming) )
+        if( channelPresent & bit )
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_8_SWITCH_WAS_OPENED);
-            Channel[CH_08].portStat.alarming = PORT_ALARMING; 
+            // Re-seated within the qualify time, no alarm
+            alarmQualify &= ~bit;
+        }
+        else if( (now - alarmQualifyStart[num]) >= (uint32_t)(profile->qualifyTime * DEBOUNCE_PROFILE_UNIT_MS) )
+        {
+            alarmQualify &= ~bit;
+            channelAlarm(num);
         }
-    }
-    else
-    {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_08].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 8 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
     }
 }
 
 
-
-static void debounceCh_09_SwitchTimerHandler(SYS_Timer_t *timer)
+// Alarms an armed channel that isn't alarming yet
+static void channelAlarm(uint8_t num)
 {
-    UNUSED(timer);
+    uint16_t bit = CH_MASK(num);
+    bool newAlarm;
     
-    if (port_pin_get_input_level(CHANNEL_9_PIN))
-    {
-        // Primary Switch - High = Open
-        Channel[CH_09].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 9 SWITCH OPENED\n");
-        
-        if ( (PORT_ARMED == Channel[CH_09].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_09].portStat.alarming) )
-        {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_9_SWITCH_WAS_OPENED);
-            Channel[CH_09].portStat.alarming = PORT_ALARMING; 
-        }
-    }
-    else
+    cpu_irq_enter_critical();
+    newAlarm = ((channelArmed & ~channelAlarming) & bit) != 0;
+    channelAlarming |= (channelArmed & bit);
+    cpu_irq_leave_critical();
+    
+    if(newAlarm)
     {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_09].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 9 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
+        channelTiming[num].alarmLatencyUs = (uint32_t)SYS_Timer_TimeUs() - channelTiming[num].edgeUs;
+        app_arm_alarmEvent(CHANNEL_0_SWITCH_WAS_OPENED + num);
     }
 }
 
 
-static void debounceCh_10_SwitchTimerHandler(SYS_Timer_t *timer)
+static void channelSwitchChanged(uint8_t num, bool open)
 {
-    UNUSED(timer);
+    uint16_t bit = CH_MASK(num);
+    ChannelTiming_t *timing = &channelTiming[num];
+    uint32_t nowUs = (uint32_t)SYS_Timer_TimeUs();
     
-    if (port_pin_get_input_level(CHANNEL_10_PIN))
+    channelTransitions[num]++;
+    inputFilterStats[inputFilter].transitions++;
+    channelDirty |= bit;
+    
+    if(edgePending & bit)
     {
-        // Primary Switch - High = Open
-        Channel[CH_10].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 10 SWITCH OPENED\n");
+        edgePending &= ~bit;
+        timing->latencyUs = nowUs - timing->edgeUs;
         
-        if ( (PORT_ARMED == Channel[CH_10].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_10].portStat.alarming) )
+        if(timing->latencyUs > timing->maxLatencyUs)
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_10_SWITCH_WAS_OPENED);
-            Channel[CH_10].portStat.alarming = PORT_ALARMING; 
+            timing->maxLatencyUs = timing->latencyUs;
         }
     }
     else
     {
-        // Primary Switch - Low = Closed
-        // Cable Switch was open or absent, but has closed
-        Channel[CH_10].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 10 SWITCH CLOSED\n");
-        
-        app_arm_reset_auto_arm_timer();     
+        // Found by polling, no edge was captured for it
+        timing->edgeUs      = nowUs;
+        timing->bounceUs    = 0;
+        timing->latencyUs   = 0;
+        timing->bounceEdges = 0;
     }
-}
-
-
-static void debounceCh_11_SwitchTimerHandler(SYS_Timer_t *timer)
-{
-    UNUSED(timer);
     
-    if (port_pin_get_input_level(CHANNEL_11_PIN))
+    if(open)
     {
         // Primary Switch - High = Open
-        Channel[CH_11].portStat.cablePresent = CABLE_ABSENT;
-        UART_DBG_TX("\n CHANNEL 11 SWITCH OPENED\n");
+        cpu_irq_enter_critical();
+        channelPresent &= ~bit;
+        cpu_irq_leave_critical();
+        
+        UART_DBG_TX("\n CHANNEL %d SWITCH OPENED\n", num);
         
-        if ( (PORT_ARMED == Channel[CH_11].portStat.armed) &&\
-             (PORT_NOT_ALARMING == Channel[CH_11].portStat.alarming) )
+        // Switch was closed but has opened, alarm if it stays open for the qualify time
+        if(0 == debounceProfiles[channelProfile[num]].qualifyTime)
+        {
+            channelAlarm(num);
+        }
+        else if(channelArmed & ~channelAlarming & bit)
         {
-            // Switch was closed but has opened
-            app_arm_alarmEvent(CHANNEL_11_SWITCH_WAS_OPENED);
-            Channel[CH_11].portStat.alarming = PORT_ALARMING; 
+            alarmQualify |= bit;
+            alarmQualifyStart[num] = SYS_Timer_Time();
         }
     }
     else
     {
         // Primary Switch - Low = Closed
         // Cable Switch was open or absent, but has closed
-        Channel[CH_11].portStat.cablePresent = CABLE_PRESENT;
-        UART_DBG_TX("\n CHANNEL 11 SWITCH CLOSED\n");
+        cpu_irq_enter_critical();
+        channelPresent |= bit;
+        cpu_irq_leave_critical();
         
-        app_arm_reset_auto_arm_timer();     
+        UART_DBG_TX("\n CHANNEL %d SWITCH CLOSED\n", num);
+        
+        app_arm_channel_closed(num);
     }
 }
 
 
-static void debounce_nDISARM_TimerHandler(SYS_Timer_t *timer)
+void debounce_nDISARM_TimerHandler(SYS_Timer_t *timer)
 {
     UNUSED(timer);
     
     // Driving this signal low disarms the unit.  
     if( port_pin_get_input_level(nDISARM_PIN) == ARM_CMD )
     {
+        app_arm_set_not_ready(ARM_NOT_READY_nDISARM, false);
         // intelli-key removed - arm attempt should be made
         // auto arm after 1 minute is CM workflow
         // app_arm_reset_auto_arm_timer(); 
@@ -880,6 +927,7 @@ static void debounce_nDISARM_TimerHandler(SYS_Timer_t *timer)
     else
     {
         // intelli-key inserted - remain disarmed
+        app_arm_set_not_ready(ARM_NOT_READY_nDISARM, true);
         app_arm_disarm(0);
         UART_DBG_TX("nDISARM: DISARM!");
     }
@@ -894,24 +942,123 @@ bool app_gen_io_get_nDISARM(void)
 }
 
 ////////////////////////////////////////////////////////////////
-// This function returns the UNIT status bits
+// This function returns the UNIT status bits, packed into the AlarmModuleStatus_t wire image
 uint16_t app_gen_io_get_AM_status(void)
 {
-    return amStatus.sAlarmModule;
+    AlarmModuleStatus_t packed;
+    
+    packed.sAlarmModule = 0;
+    packed.isMaster     = amStatus.isMaster;
+    packed.Powered      = amStatus.Powered;
+    packed.notCharging  = amStatus.notCharging;
+    packed.deepSleep    = amStatus.deepSleep;
+    packed.shutDown     = amStatus.shutDown;
+    packed.switchLifted = amStatus.switchLifted;
+    
+    return packed.sAlarmModule;
 }
 
 
 ////////////////////////////////////////////////////////////////
 uint16_t app_gen_io_get_Channel_Status(uint16_t num)
 {
-    return Channel[num].portStat.sPort;
+    PortStatus_t portStat;
+    uint16_t bit;
+    
+    if(num >= CH_COUNT)
+    {
+        return 0;
+    }
+    
+    bit = CH_MASK(num);
+    portStat.sPort        = 0;
+    portStat.cablePresent = ((channelPresent & bit) != 0);
+    portStat.armed        = ((channelArmed & bit) != 0);
+    portStat.alarming     = ((channelAlarming & bit) != 0);
+    portStat.fault        = ((channelFault & bit) != 0);
+    
+    return portStat.sPort;
+}
+
+
+////////////////////////////////////////////////////////////////
+// True once the boot inputs have been sampled and their interrupts enabled
+bool app_gen_io_is_boot_ready(void)
+{
+    return bootReady;
+}
+
+
+// Time main() ran before the SYS timers were started, boot ready is counted from there
+void app_gen_io_set_boot_start_us(uint32_t startUs)
+{
+    bootStartUs = startUs;
+}
+
+
+// Time from the start of main() to boot ready, 0 before then
+uint32_t app_gen_io_get_boot_ready_us(void)
+{
+    return bootReady ? bootReadyUs : 0;
+}
+
+
+////////////////////////////////////////////////////////////////
+// Copies the module, alarm and channel state in one critical section so a report
+// never mixes state from before and after an interrupt
+void app_gen_io_get_snapshot(StatusSnapshot_t *snapshot)
+{
+    snapshot->version      = STATUS_SNAPSHOT_VERSION;
+    snapshot->channelCount = CH_COUNT;
+    
+    cpu_irq_enter_critical();
+    snapshot->sequence      = ++snapshotSequence;
+    snapshot->uptimeMs      = SYS_Timer_Time();
+    snapshot->sAlarmModule  = app_gen_io_get_AM_status();
+    snapshot->sAlarm        = app_arm_get_alarm_status();
+    snapshot->notReady      = app_arm_get_not_ready();
+    snapshot->presentMask   = channelPresent;
+    snapshot->armedMask     = channelArmed;
+    snapshot->alarmingMask  = channelAlarming;
+    snapshot->faultMask     = channelFault;
+    snapshot->edgeOverflows = edgeRingOverflows;
+    
+    for(int num = 0; num < CH_COUNT; num++)
+    {
+        snapshot->edges[num]       = channelEdges[num];
+        snapshot->transitions[num] = channelTransitions[num];
+        snapshot->quarantines[num] = channelQuarantines[num];
+    }
+    cpu_irq_leave_critical();
+}
+
+
+// PortStatus_t of one channel as it was when the snapshot was taken
+uint16_t app_gen_io_snapshot_port_status(const StatusSnapshot_t *snapshot, uint8_t num)
+{
+    PortStatus_t portStat;
+    uint16_t bit;
+    
+    if(num >= CH_COUNT)
+    {
+        return 0;
+    }
+    
+    bit = CH_MASK(num);
+    portStat.sPort        = 0;
+    portStat.cablePresent = ((snapshot->presentMask & bit) != 0);
+    portStat.armed        = ((snapshot->armedMask & bit) != 0);
+    portStat.alarming     = ((snapshot->alarmingMask & bit) != 0);
+    portStat.fault        = ((snapshot->faultMask & bit) != 0);
+    
+    return portStat.sPort;
 }
 
 
 ////////////////////////////////////////////////////////////////
 bool app_gen_io_is_power_good(void)
 {
-    if( !SYS_TimerStarted(&debouncePowerGoodTimer) )
+    if( !SYS_TimerStarted(APP_TIMER(GEN_IO_POWER_GOOD)) )
     {
         // The de-bounce timer is not running. Check to see if we need to start it.
         if(port_pin_get_input_level(POWER_GOOD_PIN)) // Low = No Power, High = Power Good
@@ -919,7 +1066,7 @@ bool app_gen_io_is_power_good(void)
             if( POWER_NOT_GOOD == amStatus.Powered )
             {
                 // The de-bounced status and the pin don't agree. Start the debounce timer.
-                SYS_TimerStart(&debouncePowerGoodTimer);
+                SYS_TimerStart(APP_TIMER(GEN_IO_POWER_GOOD));
             }
         }
         else
@@ -927,7 +1074,7 @@ bool app_gen_io_is_power_good(void)
             if( POWER_NOT_GOOD == amStatus.Powered )
             {
                 // The de-bounced status and the pin don't agree. Start the debounce timer.
-                SYS_TimerStart(&debouncePowerGoodTimer);
+                SYS_TimerStart(APP_TIMER(GEN_IO_POWER_GOOD));
             }
         }
     }
@@ -946,7 +1093,7 @@ bool app_gen_io_is_cable_present(uint8_t portNum)
         return false;
     }
     
-    return (Channel[portNum].portStat.cablePresent);
+    return ((channelPresent & CH_MASK(portNum)) != 0);
 }
 
 ////////////////////////////////////////////////////////////////
@@ -958,7 +1105,7 @@ bool app_gen_io_is_port_armed(uint8_t portNum)
         return false;
     }
     
-    return (Channel[portNum].portStat.armed);
+    return ((channelArmed & CH_MASK(portNum)) != 0);
 }
 
 
@@ -970,39 +1117,290 @@ void app_gen_io_set_port_armed(uint8_t portNum, bool desiredArmState)
         return;
     }
     
-    Channel[portNum].portStat.alarming = DIDNT_ALARM;               // Only true when actually alarming or silent alarming 
-    
     if( desiredArmState )
     {
-        Channel[portNum].portStat.armed = SENSOR_ARMED; 
-        Channel[portNum].portStat.cablePresent = CABLE_PRESENT; 
+        app_gen_io_arm_ports(CH_MASK(portNum));
     }
     else
     {
-        Channel[portNum].portStat.armed = SENSOR_DISARMED;
+        app_gen_io_disarm_ports(CH_MASK(portNum));
     }
 }
 
 ////////////////////////////////////////////////////////////////
 bool app_gen_io_is_any_port_armed(void)
 {
-    bool portArmed = PORT_DISARMED; 
+    return (0 != channelArmed);
+}
+
+bool app_gen_io_is_port_alarming(uint8_t portNum)
+{
+    return ((channelAlarming & CH_MASK(portNum)) != 0);
+}
+
+////////////////////////////////////////////////////////////////
+uint16_t app_gen_io_get_present_mask(void)
+{
+    return channelPresent;
+}
+
+uint16_t app_gen_io_get_armed_mask(void)
+{
+    return channelArmed;
+}
+
+uint16_t app_gen_io_get_alarming_mask(void)
+{
+    return channelAlarming;
+}
+
+uint16_t app_gen_io_get_fault_mask(void)
+{
+    return channelFault;
+}
+
+// Channels that reported a transition since the last call, and clears them
+uint16_t app_gen_io_take_dirty_mask(void)
+{
+    uint16_t dirty;
+    
+    cpu_irq_enter_critical();
+    dirty = channelDirty;
+    channelDirty = 0;
+    cpu_irq_leave_critical();
+    
+    return dirty;
+}
+
+////////////////////////////////////////////////////////////////
+// Arms every port in portMask and clears its alarm. An armed port is a present
+// port, so those are marked present too. Returns the ports that were disarmed before.
+uint16_t app_gen_io_arm_ports(uint16_t portMask)
+{
+    uint16_t newlyArmed;
+    
+    portMask &= CH_ALL_MASK;
+    
+    cpu_irq_enter_critical();
+    newlyArmed       = portMask & ~channelArmed;
+    channelArmed    |= portMask;
+    channelPresent  |= portMask;
+    channelAlarming &= ~portMask;                  // Only true when actually alarming or silent alarming 
+    cpu_irq_leave_critical();
+    
+    return newlyArmed;
+}
+
+////////////////////////////////////////////////////////////////
+void app_gen_io_disarm_ports(uint16_t portMask)
+{
+    cpu_irq_enter_critical();
+    channelArmed    &= ~portMask;
+    channelAlarming &= ~portMask;
+    cpu_irq_leave_critical();
+}
+
+////////////////////////////////////////////////////////////////
+// Times this channel was quarantined for chatter since boot
+uint16_t app_gen_io_get_channel_quarantines(uint8_t portNum)
+{
+    if(portNum >= CH_COUNT)
+    {
+        return 0;
+    }
+    
+    return channelQuarantines[portNum];
+}
+
+////////////////////////////////////////////////////////////////
+// Debounced open/close transitions reported on this channel since boot, wraps.
+// Edges minus transitions is the bounce that got past the EIC filter.
+uint16_t app_gen_io_get_channel_transitions(uint8_t portNum)
+{
+    if(portNum >= CH_COUNT)
+    {
+        return 0;
+    }
     
-    for (int num = 0 ; num < CH_COUNT ; num++ )
+    return channelTransitions[portNum];
+}
+
+////////////////////////////////////////////////////////////////
+// Edge capture timing of the last transition on this channel
+const ChannelTiming_t *app_gen_io_get_channel_timing(uint8_t portNum)
+{
+    if(portNum >= CH_COUNT)
+    {
+        return NULL;
+    }
+    
+    return &channelTiming[portNum];
+}
+
+////////////////////////////////////////////////////////////////
+// Debounce profiles, kept in the debounce config bytes of the user config page
+static void debounceProfilesLoad(void)
+{
+    uint8_t debounceConfig[EEPROM_BYTES_DEBOUNCE_CONFIG];
+    
+    if((STATUS_OK == app_eeprom_read_debounceConfig(debounceConfig)) &&
+       (DEBOUNCE_CONFIG_MAGIC == debounceConfig[DEBOUNCE_CONFIG_INDEX_MAGIC]))
     {
-        if(PORT_ARMED == Channel[num].portStat.armed)
+        memcpy(debounceProfiles, &debounceConfig[DEBOUNCE_CONFIG_INDEX_PROFILES], sizeof(debounceProfiles));
+        
+        for(int num = 0; num < CH_COUNT; num++)
         {
-           portArmed = PORT_ARMED;
-           continue;
+            channelProfile[num] = (debounceConfig[DEBOUNCE_CONFIG_INDEX_CHANNEL_PROFILES + (num / 2)] >> ((num % 2) * 4)) & 0x0F;
+            
+            if(channelProfile[num] >= DEBOUNCE_PROFILE_COUNT)
+            {
+                channelProfile[num] = 0;
+            }
         }
     }
+    else
+    {
+        // Nothing saved yet or no EEPROM, every channel on the standard debounce and no qualify time
+        for(int num = 0; num < DEBOUNCE_PROFILE_COUNT; num++)
+        {
+            debounceProfiles[num].liftTime    = DEBOUNCE_DEFAULT_LIFT_TIME;
+            debounceProfiles[num].pressTime   = DEBOUNCE_DEFAULT_PRESS_TIME;
+            debounceProfiles[num].qualifyTime = DEBOUNCE_DEFAULT_QUALIFY_TIME;
+        }
+        
+        memset(channelProfile, 0, sizeof(channelProfile));
+    }
+}
+
+
+static enum status_code debounceProfilesSave(void)
+{
+    uint8_t debounceConfig[EEPROM_BYTES_DEBOUNCE_CONFIG];
+    
+    debounceConfig[DEBOUNCE_CONFIG_INDEX_MAGIC] = DEBOUNCE_CONFIG_MAGIC;
+    memcpy(&debounceConfig[DEBOUNCE_CONFIG_INDEX_PROFILES], debounceProfiles, sizeof(debounceProfiles));
+    memset(&debounceConfig[DEBOUNCE_CONFIG_INDEX_CHANNEL_PROFILES], 0, CH_MAX_COUNT / 2);
+    
+    for(int num = 0; num < CH_COUNT; num++)
+    {
+        debounceConfig[DEBOUNCE_CONFIG_INDEX_CHANNEL_PROFILES + (num / 2)] |= channelProfile[num] << ((num % 2) * 4);
+    }
+    
+    return app_eeprom_write_debounceConfig(debounceConfig);
+}
 
-    return portArmed;
+
+const DebounceProfile_t *app_gen_io_get_debounce_profile(uint8_t profileNum)
+{
+    if(profileNum >= DEBOUNCE_PROFILE_COUNT)
+    {
+        return NULL;
+    }
+    
+    return &debounceProfiles[profileNum];
 }
 
-bool app_gen_io_is_port_alarming(uint8_t portNum)
+
+// The profile is used from now on, the status is whether it was also saved
+enum status_code app_gen_io_set_debounce_profile(uint8_t profileNum, const DebounceProfile_t *profile)
+{
+    if(profileNum >= DEBOUNCE_PROFILE_COUNT)
+    {
+        return STATUS_ERR_INVALID_ARG;
+    }
+    
+    debounceProfiles[profileNum] = *profile;
+    return debounceProfilesSave();
+}
+
+
+uint8_t app_gen_io_get_channel_profile(uint8_t portNum)
+{
+    if(portNum >= CH_COUNT)
+    {
+        return 0;
+    }
+    
+    return channelProfile[portNum];
+}
+
+
+// As app_gen_io_set_debounce_profile()
+enum status_code app_gen_io_set_channel_profile(uint8_t portNum, uint8_t profileNum)
+{
+    if((portNum >= CH_COUNT) || (profileNum >= DEBOUNCE_PROFILE_COUNT))
+    {
+        return STATUS_ERR_INVALID_ARG;
+    }
+    
+    channelProfile[portNum] = profileNum;
+    return debounceProfilesSave();
+}
+
+////////////////////////////////////////////////////////////////
+// Turns the EIC filter on the channel lines on or off. The counts carry on in the
+// totals of the new setting, so edges per debounced transition can be compared.
+void app_gen_io_set_input_filter(bool filter)
 {
-    return Channel[portNum].portStat.alarming;
+    uint32_t now = SYS_Timer_Time();
+    
+    cpu_irq_enter_critical();
+    inputFilterStats[inputFilter].timeMs += now - inputFilterSince;
+    inputFilterSince = now;
+    inputFilter = filter;
+    
+    for(int num = 0; num < CH_COUNT; num++)
+    {
+        channelEicConfig(num);
+    }
+    cpu_irq_leave_critical();
+}
+
+
+bool app_gen_io_get_input_filter(void)
+{
+    return inputFilter;
+}
+
+
+// Channel edges and debounced transitions counted while the filter was in this setting
+void app_gen_io_get_input_filter_stats(bool filter, InputFilterStats_t *stats)
+{
+    cpu_irq_enter_critical();
+    *stats = inputFilterStats[filter];
+    if(filter == inputFilter)
+    {
+        stats->timeMs += SYS_Timer_Time() - inputFilterSince;
+    }
+    cpu_irq_leave_critical();
+}
+
+////////////////////////////////////////////////////////////////
+uint16_t app_gen_io_get_edge_overflows(void)
+{
+    return edgeRingOverflows;
+}
+
+#ifdef SYS_TIMER_PROFILE
+////////////////////////////////////////////////////////////////
+void app_gen_io_get_channel_isr_profile(ChannelIsrProfile_t *profile)
+{
+    cpu_irq_enter_critical();
+    *profile = channelIsrProfile;
+    cpu_irq_leave_critical();
+}
+#endif
+
+////////////////////////////////////////////////////////////////
+// Edge interrupts seen on this channel since boot, wraps
+uint16_t app_gen_io_get_channel_edges(uint8_t portNum)
+{
+    if(portNum >= CH_COUNT)
+    {
+        return 0;
+    }
+    
+    return channelEdges[portNum];
 }
 
 
@@ -1010,7 +1408,7 @@ void app_gen_io_multiport_blink(uint8_t multiportFlashCounter)
 {
     for(int num = 0 ; num < CH_COUNT ; num++)
     {
-        if(PORT_DISARMED == Channel[num].portStat.armed)
+        if(!(channelArmed & CH_MASK(num)))
         {
             if((multiportFlashCounter == 5) || (multiportFlashCounter == 7))
             {
@@ -20,7 +20,35 @@
 
 // Debounce and vibration constants
 #define STANDARD_DEBOUNCE_INTERVAL_MS       250
+#define DEBOUNCE_TICK_MS                    5       // Channel sample period while a channel is changing
+#define DEBOUNCE_SAMPLE_COUNT               4       // Fixed by the 2 bit vertical counter
+#define DEBOUNCE_FILTER_MS                  (DEBOUNCE_TICK_MS * DEBOUNCE_SAMPLE_COUNT)  // Shortest channel debounce
+
+// Channel debounce profiles. Each channel uses one of DEBOUNCE_PROFILE_COUNT profiles, times
+// are in DEBOUNCE_PROFILE_UNIT_MS units. Profile 0 is the default for every channel.
+#define DEBOUNCE_PROFILE_COUNT              4
+#define DEBOUNCE_PROFILE_UNIT_MS            10
+#define DEBOUNCE_DEFAULT_LIFT_TIME          (STANDARD_DEBOUNCE_INTERVAL_MS / DEBOUNCE_PROFILE_UNIT_MS)
+#define DEBOUNCE_DEFAULT_PRESS_TIME         (STANDARD_DEBOUNCE_INTERVAL_MS / DEBOUNCE_PROFILE_UNIT_MS)
+#define DEBOUNCE_DEFAULT_QUALIFY_TIME       0
 #define SHELF_STORAGE_MESSAGE_INTERVAL_MS   2000
+#define BOOT_SETTLE_MS                      100     // Input settle time after the pins are configured at boot
+
+// EIC majority filter (FILTENx) on the channel, nDISARM, power good and ARM lines. Each line
+// takes 2 of 3 samples at GCLK_EIC (8 MHz / 128), so spikes under ~32 us never interrupt.
+// Set to false to leave all of the filtering to the software debounce. The channel lines
+// can also be switched at run time (EF) to count spurious edges with and without it.
+#define EIC_INPUT_FILTER                    true
+
+// Channel edge timestamp ring filled by the channel interrupt, power of 2
+#define EDGE_RING_SIZE                      32
+
+// Chatter quarantine - a channel that interrupts faster than this gets its EIC line masked
+// and is polled until it holds one level for CHATTER_RELEASE_POLLS polls in a row
+#define CHATTER_WINDOW_MS                   1000
+#define CHATTER_EDGE_LIMIT                  20      // Edges per window
+#define CHATTER_POLL_INTERVAL_MS            500
+#define CHATTER_RELEASE_POLLS               10
 #define CABLE_ALARM_COUNTDOWN_INTERVAL_MS   10000
 
 enum
@@ -72,6 +100,18 @@ enum
 //     PORT_STATUS_LIFTED               = 1 << 7,
 // };
 
+// Number of populated channels, a build-time parameter. Channels 0..CH_COUNT-1 are
+// taken from the CHANNEL_n pin definitions in conf_board.h.
+#ifndef CH_COUNT
+#define CH_COUNT            12
+#endif
+
+#define CH_MAX_COUNT        12          // Channel pins defined in conf_board.h
+
+#if (CH_COUNT < 1) || (CH_COUNT > CH_MAX_COUNT)
+#error "CH_COUNT must be between 1 and CH_MAX_COUNT"
+#endif
+
 enum channel_num
 {
     CH_00 = 0,         // 0
@@ -85,13 +125,17 @@ enum channel_num
     CH_08,
     CH_09,
     CH_10,
-    CH_11,
-    CH_COUNT,			// 12
+    CH_11,             // 11
 };
 
+#define CH_NONE             0xFF        // EIC line not used by a channel
 
-typedef void (*timerHandler_function)(SYS_Timer_t *timer);
+#define CH_MASK(num)        ((uint16_t)(1u << (num)))
+#define CH_ALL_MASK         ((uint16_t)((1u << CH_COUNT) - 1))
 
+
+// Wire images of the channel and module status, only built when status is reported.
+// Runtime state is kept unpacked in app_gen_io.c.
 COMPILER_PACK_SET(1)
 
 typedef struct PortStatus_t
@@ -103,7 +147,8 @@ typedef struct PortStatus_t
             uint16_t cablePresent   : 1;                // 1 =
             uint16_t armed          : 1;                // 1 = Armed
             uint16_t alarming       : 1;                // 1 = alarming
-            uint16_t reserved       : 13;
+            uint16_t fault          : 1;                // 1 = input not trusted
+            uint16_t reserved       : 12;
         };
         uint16_t sPort;
     };
@@ -127,20 +172,92 @@ typedef struct AlarmModuleStatus_t
     };
 } AlarmModuleStatus_t;
 
+COMPILER_PACK_RESET()
+
+// One channel edge as captured in the interrupt
+typedef struct ChannelEdge_t
+{
+    uint32_t    timeUs;                             // SYS_Timer_TimeUs() at the interrupt, low 32 bits
+    uint8_t     line;                               // EIC line
+    uint8_t     level;                              // Pin level just after the edge
+} ChannelEdge_t;
+
+// Timing of the last debounced transition of a channel, from the edge ring
+typedef struct ChannelTiming_t
+{
+    uint32_t    edgeUs;                             // First edge of the transition (time of lift/seat)
+    uint32_t    bounceUs;                           // First to last edge of the transition
+    uint32_t    latencyUs;                          // First edge to report
+    uint32_t    maxLatencyUs;                       // Worst latencyUs since boot
+    uint32_t    alarmLatencyUs;                     // First edge to alarm, last alarm of this channel
+    uint16_t    bounceEdges;                        // Edges in the transition
+} ChannelTiming_t;
+
+// Debounce and alarm qualification profile, DEBOUNCE_PROFILE_UNIT_MS units
+typedef struct DebounceProfile_t
+{
+    uint8_t     liftTime;                           // Open must hold this long to be reported
+    uint8_t     pressTime;                          // Closed must hold this long to be reported
+    uint8_t     qualifyTime;                        // An armed port must stay open this long to alarm
+} DebounceProfile_t;
+
+// Whole-module status taken in one critical section by app_gen_io_get_snapshot().
+// Bump STATUS_SNAPSHOT_VERSION when the layout changes.
+#define STATUS_SNAPSHOT_VERSION             2
+
+typedef struct StatusSnapshot_t
+{
+    uint8_t     version;                            // STATUS_SNAPSHOT_VERSION
+    uint8_t     channelCount;                       // CH_COUNT
+    uint16_t    sequence;                           // Counts snapshots taken, wraps
+    uint32_t    uptimeMs;
+    uint16_t    sAlarmModule;                       // AlarmModuleStatus_t
+    uint16_t    sAlarm;                             // AlarmStatus_t
+    uint32_t    notReady;                           // ARM_NOT_READY_* reasons, app_arm_get_not_ready()
+    uint16_t    presentMask;                        // Channel bitmaps, bit n = channel n
+    uint16_t    armedMask;
+    uint16_t    alarmingMask;
+    uint16_t    faultMask;
+    uint16_t    edgeOverflows;
+    uint16_t    edges[CH_COUNT];
+    uint16_t    transitions[CH_COUNT];
+    uint16_t    quarantines[CH_COUNT];
+} StatusSnapshot_t;
+
+#ifdef SYS_TIMER_PROFILE
+// Channel interrupt run time in hw timer counts, HW_TIMER_PERIOD per ms. The debounce
+// sample tick is profiled with the other SYS timers.
+typedef struct ChannelIsrProfile_t
+{
+    uint32_t    runs;
+    uint32_t    totalCounts;
+    uint16_t    maxCounts;
+} ChannelIsrProfile_t;
+#endif
+
+// Channel edges counted with the EIC filter in one setting. Edges that never became
+// a debounced transition are the spurious interrupts, (edges - transitions).
+typedef struct InputFilterStats_t
+{
+    uint32_t    edges;
+    uint32_t    transitions;
+    uint32_t    timeMs;                             // Time spent in this setting
+} InputFilterStats_t;
+
 // These bits reflect hardware status
 typedef struct ChannelStatus_t
 {
     const uint32_t          gpio_pin;               // The uC pin number of this Stud (ex: port A8)
     const uint32_t          gpio_eic_mux;           // EIC MUX
     const uint32_t          gpio_eic_line;          // EIC LINE
-    SYS_Timer_t             *timer; 
-    timerHandler_function   timerHandler;                   // pointer to the Channels timerHandler Function                  
-    volatile PortStatus_t   portStat;               // Cable
 } ChannelStatus_t;
 
-COMPILER_PACK_RESET()
+extern const ChannelStatus_t Channel[CH_COUNT];
 
 void app_gen_io_init(void);
+bool app_gen_io_is_boot_ready(void);
+void app_gen_io_set_boot_start_us(uint32_t startUs);
+uint32_t app_gen_io_get_boot_ready_us(void);
 
 
 
@@ -150,11 +267,37 @@ uint16_t app_gen_io_get_port_status(uint8_t portNum);
 void app_gen_io_kill_switch_task(void);
 void app_gen_io_set_status_deepSleep(uint16_t sleepState);
 uint16_t app_gen_io_get_Channel_Status(uint16_t num);
+void app_gen_io_get_snapshot(StatusSnapshot_t *snapshot);
+uint16_t app_gen_io_snapshot_port_status(const StatusSnapshot_t *snapshot, uint8_t num);
 bool app_gen_io_is_power_good(void);
 bool app_gen_io_is_cable_present(uint8_t portNum);
 bool app_gen_io_is_port_armed(uint8_t portNum);
 void app_gen_io_set_port_armed(uint8_t portNum, bool desiredArmState);
 bool app_gen_io_is_any_port_armed(void);
 bool app_gen_io_is_port_alarming(uint8_t portNum);
+uint16_t app_gen_io_get_channel_edges(uint8_t portNum);
+uint16_t app_gen_io_get_channel_quarantines(uint8_t portNum);
+uint16_t app_gen_io_get_channel_transitions(uint8_t portNum);
+const ChannelTiming_t *app_gen_io_get_channel_timing(uint8_t portNum);
+uint16_t app_gen_io_get_edge_overflows(void);
+void app_gen_io_set_input_filter(bool filter);
+bool app_gen_io_get_input_filter(void);
+void app_gen_io_get_input_filter_stats(bool filter, InputFilterStats_t *stats);
+#ifdef SYS_TIMER_PROFILE
+void app_gen_io_get_channel_isr_profile(ChannelIsrProfile_t *profile);
+#endif
+const DebounceProfile_t *app_gen_io_get_debounce_profile(uint8_t profileNum);
+enum status_code app_gen_io_set_debounce_profile(uint8_t profileNum, const DebounceProfile_t *profile);
+uint8_t app_gen_io_get_channel_profile(uint8_t portNum);
+enum status_code app_gen_io_set_channel_profile(uint8_t portNum, uint8_t profileNum);
+
+// Channel state bitmaps, bit n = channel n
+uint16_t app_gen_io_get_present_mask(void);
+uint16_t app_gen_io_get_armed_mask(void);
+uint16_t app_gen_io_get_alarming_mask(void);
+uint16_t app_gen_io_get_fault_mask(void);
+uint16_t app_gen_io_take_dirty_mask(void);
+uint16_t app_gen_io_arm_ports(uint16_t portMask);
+void app_gen_io_disarm_ports(uint16_t portMask);
 
 #endif /* APP_GEN_IO_H_ */
@@ -0,0 +1,32 @@
+/*
+ * app_timers.c
+ *
+ * The registered timers, built from APP_TIMER_LIST so their parameters come
+ * from flash with the rest of .data and need no init code.
+ */
+
+
+#include <asf.h>
+#include "app_timers.h"
+
+// ****************************************************************************
+//		Variables
+#define APP_TIMER_INIT(_id, _interval, _slack, _mode, _domain, _handler) \
+    [APP_TIMER_ID_##_id] = { .interval = (_interval), .slack = (_slack), .mode = (_mode), .domain = (_domain), .handler = (_handler) },
+SYS_Timer_t appTimers[APP_TIMER_COUNT] = {APP_TIMER_LIST(APP_TIMER_INIT)};
+#undef APP_TIMER_INIT
+
+#define APP_TIMER_NAME(_id, _interval, _slack, _mode, _domain, _handler) [APP_TIMER_ID_##_id] = #_id,
+static const char *const appTimerNames[APP_TIMER_COUNT] = {APP_TIMER_LIST(APP_TIMER_NAME)};
+#undef APP_TIMER_NAME
+
+// ****************************************************************************
+//		Name of a registered timer, NULL for a timer declared in its module
+const char *app_timers_get_name(SYS_Timer_t *timer)
+{
+    if ((timer < &appTimers[0]) || (timer >= &appTimers[APP_TIMER_COUNT]))
+    {
+        return NULL;
+    }
+    return appTimerNames[timer - appTimers];
+}
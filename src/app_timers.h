@@ -0,0 +1,64 @@
+/*
+ * app_timers.h
+ *
+ * Build time registry of the timers whose interval, mode and handler never
+ * change. One list generates the timer IDs, the initialized timer array, the
+ * handler prototypes and the names the TP command prints, so a timer is added
+ * in one place.
+ *
+ * Timers whose parameters change at runtime (auto-arm, disarm duration, LED
+ * flash, buzzer note, daisy chain) are still declared in their modules.
+ */
+
+
+#ifndef APP_TIMERS_H_
+#define APP_TIMERS_H_
+
+#include "sysTimer.h"
+#include "slpTimer.h"
+#include "conf_adc.h"
+#include "app_arm.h"
+#include "app_bbu.h"
+#include "app_gen_io.h"
+
+// clang-format off
+//      ID                      Interval ms                         Slack ms            Mode                        Domain                  Handler
+#define APP_TIMER_LIST(X) \
+    X(ADC_CHECK,                CONF_ADC_CHK_TMR_INTERVAL,          0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_ISR,   adcCheckTimerHandler) \
+    X(ARM_ALARM_EVENT,          0,                                  0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  alarmEventTimerHandler) /* Next tick */ \
+    X(ARM_TAMPER_LIMIT,         ALARM_TIME_BEFORE_SILENT,           0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  tamperLimitTimerHandler) \
+    X(ARM_DISARM_FLASH,         DISARM_FLASH_TIME,                  DISARM_FLASH_SLACK, SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  appDisarmFlashTimerHandler) \
+    X(BBU_BATTERY_CHECK,        20000,                              1000,               SYS_TIMER_PERIODIC_MODE,    SYS_TIMER_DOMAIN_TASK,  appBatteryCheckTimerHandler) \
+    X(BBU_LIMIT,                BBU_TIME_LIMIT,                     0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_ISR,   appBBUTimeLimitTimerHandler) \
+    X(BOOT_UPDATE_TIMEOUT,      5000,                               0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  updateTimeoutTimerHandler) \
+    X(BOOT_UPDATE_REBOOT,       500,                                0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  updateRebootTimerHandler) \
+    X(GEN_IO_POWER_GOOD,        STANDARD_DEBOUNCE_INTERVAL_MS,      0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  debouncePowerGoodTimerHandler) \
+    X(GEN_IO_nMASTER,           STANDARD_DEBOUNCE_INTERVAL_MS,      0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  debounce_nMASTERTimerHandler) \
+    X(GEN_IO_nDISARM,           STANDARD_DEBOUNCE_INTERVAL_MS,      0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  debounce_nDISARM_TimerHandler) \
+    X(GEN_IO_SHELF_STORAGE,     SHELF_STORAGE_MESSAGE_INTERVAL_MS,  0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_ISR,   shelfStorageConditionTimerHandler) \
+    X(GEN_IO_BOOT_SETTLE,       BOOT_SETTLE_MS,                     0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  bootSettleTimerHandler) \
+    X(GEN_IO_DEBOUNCE_SAMPLE,   DEBOUNCE_TICK_MS,                   0,                  SYS_TIMER_PERIODIC_MODE,    SYS_TIMER_DOMAIN_TASK,  debounceSampleTimerHandler) \
+    X(GEN_IO_CHATTER_POLL,      CHATTER_POLL_INTERVAL_MS,           0,                  SYS_TIMER_PERIODIC_MODE,    SYS_TIMER_DOMAIN_ISR,   chatterPollTimerHandler) \
+    X(UART_DMA,                 25,                                 0,                  SYS_TIMER_INTERVAL_MODE,    SYS_TIMER_DOMAIN_TASK,  dmaTimerHandler)
+// clang-format on
+
+#define APP_TIMER_ID(_id, _interval, _slack, _mode, _domain, _handler) APP_TIMER_ID_##_id,
+typedef enum AppTimerId_t
+{
+    APP_TIMER_LIST(APP_TIMER_ID)
+    APP_TIMER_COUNT,
+} AppTimerId_t;
+#undef APP_TIMER_ID
+
+#define APP_TIMER_HANDLER(_id, _interval, _slack, _mode, _domain, _handler) void _handler(SYS_Timer_t *timer);
+APP_TIMER_LIST(APP_TIMER_HANDLER)
+#undef APP_TIMER_HANDLER
+
+extern SYS_Timer_t appTimers[APP_TIMER_COUNT];
+
+// Registered timer by ID, e.g. SYS_TimerStart(APP_TIMER(UART_DMA))
+#define APP_TIMER(_id)  (&appTimers[APP_TIMER_ID_##_id])
+
+const char *app_timers_get_name(SYS_Timer_t *timer);
+
+#endif /* APP_TIMERS_H_ */
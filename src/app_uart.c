@@ -36,9 +36,11 @@
 #include "app_buzzer.h"
 //#include "app_eeprom.h"  // For HW Model Number (150-00XXX), HW Version No, DMA
 #include "app_gen_io.h"  // Functions and ISRs
+#include "app_timers.h"
 //#include "app_rfid_state.h"
 #include "conf_board.h"  // #defines
 #include "config.h"      // For Firmware Version
+#include "hw_timer.h"
 #include "sysTimer.h"
 
 #warning "TODO: re-enable uart includes"
@@ -84,7 +86,6 @@ static bool allowTempDebugData;
 static uint8_t dmaBuff[DMA_BUFFER_SIZE];
 static VPCircBuf_Element rxBuff[CIRC_BUFFER_SIZE];
 static VPCircBuf rxCircBuff;
-static SYS_Timer_t dmaTimer;
 
 static struct usart_module usart_instance;
 struct dma_resource usart_dma_resource_rx;
@@ -108,16 +109,21 @@ static bool alt_update_packet = false;
 //					Function Prototypes
 // ****************************************************************************
 
-static void dmaTimerHandler(SYS_Timer_t* timer);
 void app_uart_tx(void);
 void usart_error_callback(struct usart_module* const usart_module);
 void usart_read_callback(struct usart_module* const usart_module);
 void usart_write_callback(struct usart_module* const usart_module);
 static void app_uart_printResetReason(uint8_t resetCause);
+static void app_uart_printSaveStatus(enum status_code status);
 
 
+static void handleAT(char* msg);  // Arm Trace
 static void handleBV(char* msg);  // Get Battery Voltage
 static void handleCR(char* msg);  // Print Debug data to uart
+static void handleDC(char* msg);  // Debounce profile of a Channel
+static void handleDL(char* msg);  // Debounce Latency
+static void handleDP(char* msg);  // set Debounce Profile
+static void handleEF(char* msg);  // EIC Filter
 static void handleFF(char* msg);  // Free Function
 static void handleGS(char* msg);  // Get Sensor Status
 static void handleGV(char* msg);  // Get Version Request
@@ -127,6 +133,13 @@ static void handleSA(char* msg);  // Set Arm
 static void handleSH(char* msg);  // Set userConfig
 static void handleSU(char* msg);  // Start Update
 static void handleSW(char* msg);  // Switch Update
+static void handleTS(char* msg);  // Timer Stats
+#ifdef SYS_TIMER_PROFILE
+static void handleTP(char* msg);  // Timer Profile
+#endif
+static void handleZC(char* msg);  // Zone Channels
+static void handleZD(char* msg);  // Zone Disarm
+static void handleZT(char* msg);  // Zone Times
 static void handleQM(char* msg);  // Get HELP
 
 // ****************************************************************************
@@ -136,8 +149,13 @@ static void handleQM(char* msg);  // Get HELP
 // clang-format off
 static Command commands[] = {
     // ID  len Error                                                Handler
+    {"AT", 2,  "NG Error - AT\n",                                   handleAT},
     {"BV", 2,  "NG Error - BV\n",                                   handleBV},
     {"CR", 2,  "NG Error - CR\n",                                   handleCR},
+    {"DC", 5,  "NG Error - DC <C><P>\n",                            handleDC},
+    {"DL", 2,  "NG Error - DL\n",                                   handleDL},
+    {"DP", 10, "NG Error - DP <P><LL><PP><QQ>\n",                   handleDP},
+    {"EF", 4,  "NG Error - EF <N>\n",                               handleEF},
     {"FF", 2,  "NG Error - FF\n",                                   handleFF},
     {"GS", 2,  "NG Error - GS\n",                                   handleGS},
     {"GV", 2,  "NG Error - GV\n",                                   handleGV},
@@ -147,6 +165,13 @@ static Command commands[] = {
     {"SH", 9,  "NG Error - SH <VV><AA><SS>\n",                      handleSH},
     {"SU", 10, "NG Error - SU<BBBB><CCCC>\r",                       handleSU},
     {"SW", 2,  "NG Error - SW\r",                                   handleSW},
+    {"TS", 2,  "NG Error - TS\n",                                   handleTS},
+#ifdef SYS_TIMER_PROFILE
+    {"TP", 2,  "NG Error - TP\n",                                   handleTP},
+#endif
+    {"ZC", 7,  "NG Error - ZC <Z><MMM>\n",                          handleZC},
+    {"ZD", 4,  "NG Error - ZD <Z>\n",                               handleZD},
+    {"ZT", 12, "NG Error - ZT <Z><AAAA><LLLL>\n",                   handleZT},
     {"??", 2,  "NG Error - ??\n",                                   handleQM},
     {NULL, 0, NULL, NULL}};
 // clang-format on
@@ -155,7 +180,7 @@ static Command commands[] = {
 //					INITILIZATIONS
 // ****************************************************************************
 
-static void dmaTimerHandler(SYS_Timer_t* timer)
+void dmaTimerHandler(SYS_Timer_t* timer)
 {
     UNUSED(timer);
 
@@ -184,9 +209,9 @@ static void dmaTimerHandler(SYS_Timer_t* timer)
 
 static void transfer_done_rx(struct dma_resource* const resource)
 {
-    if (SYS_TimerStarted(&dmaTimer))
+    if (SYS_TimerStarted(APP_TIMER(UART_DMA)))
     {
-        SYS_TimerStop(&dmaTimer);
+        SYS_TimerStop(APP_TIMER(UART_DMA));
     }
 
     if ((usart_instance.hw->USART.CTRLA.reg & SERCOM_USART_CTRLA_ENABLE))  // Only do this if I have a UART setup
@@ -208,7 +233,7 @@ void usart_read_callback(struct usart_module* const usart_module)
     usart_instance.hw->USART.INTENSET.reg = SERCOM_USART_INTFLAG_RXS;
     // Gets cleared in interrupt handler
 
-    SYS_TimerRestart(&dmaTimer);
+    SYS_TimerRestart(APP_TIMER(UART_DMA));
 
     #warning "TODO: add BBU"
 //    app_bbu_sleep_on_exit(false);
@@ -221,9 +246,6 @@ void app_uart_enable(void)
 
     vpCircBuf_init(&rxCircBuff, rxBuff, CIRC_BUFFER_SIZE);
 
-    dmaTimer.interval = 25;
-    dmaTimer.mode     = SYS_TIMER_INTERVAL_MODE;
-    dmaTimer.handler  = dmaTimerHandler;
 
     struct usart_config config_usart;
     struct dma_resource_config config_dma_resource_rx;
@@ -240,8 +262,14 @@ void app_uart_enable(void)
     config_usart.pinmux_pad1                  = DEBUG_UART_SERCOM_PINMUX_PAD1;
     config_usart.pinmux_pad2                  = DEBUG_UART_SERCOM_PINMUX_PAD2;
     config_usart.pinmux_pad3                  = DEBUG_UART_SERCOM_PINMUX_PAD3;
+    uint16_t retries = USART_INIT_RETRIES;
     while (usart_init(&usart_instance, DEBUG_UART_MODULE, &config_usart) != STATUS_OK)
     {
+        if (0 == --retries)
+        {
+            // Leave the SERCOM disabled, UART_TX() drops output while it is
+            return;
+        }
     }
 
     stdio_serial_init(&usart_instance, DEBUG_UART_MODULE, &config_usart);
@@ -421,6 +449,41 @@ void app_arraySN_to_strSN(uint8_t* strSN, uint8_t* arraySN)
 //					UART Message Functions
 // ****************************************************************************
 
+static void handleAT(char* msg)
+{
+    static const char* const stateNames[ARM_STATE_COUNT] = {"DISARMED", "ARMED", "ALARMING", "SILENT"};
+    static const char* const eventNames[ARM_EVENT_COUNT] = {"ARM", "AUTO_ARM", "DISARM", "SILENCE", "ALARM"};
+    ArmTrace_t trace;
+    uint32_t posted;
+    uint32_t coalesced;
+    uint32_t dropped;
+    uint32_t evaluations;
+    uint32_t skips;
+
+    app_arm_get_alarm_event_stats(&posted, &coalesced, &dropped);
+    app_arm_get_auto_arm_stats(&evaluations, &skips);
+
+    UART_TX("\n\nARM TRACE, newest first:\n");
+    for (uint8_t zone = 0; zone < ARM_ZONE_COUNT; zone++)
+    {
+        UART_TX("\tZone %u: %s, channels 0x%03x\n", zone, stateNames[app_arm_get_state(zone)],
+                app_arm_get_zone_channels(zone));
+    }
+    UART_TX("\tAlarm events: %lu posted, %lu coalesced, %lu dropped\n", (unsigned long)posted,
+            (unsigned long)coalesced, (unsigned long)dropped);
+    UART_TX("\tAuto-arm: %lu evaluations, %lu skipped\n", (unsigned long)evaluations, (unsigned long)skips);
+
+    for (uint8_t age = 0; app_arm_get_trace(age, &trace); age++)
+    {
+        UART_TX("\t%lu ms zone %u %s", (unsigned long)trace.timeMs, trace.zone, eventNames[trace.event]);
+        if (ARM_TRACE_NO_CAUSE != trace.cause)
+        {
+            UART_TX(" cause %u", trace.cause);
+        }
+        UART_TX(" %s -> %s\n", stateNames[trace.from], stateNames[trace.to]);
+    }
+}
+
 static void handleBV(char* msg)  // Get Battery Voltage
 {
 //     UART_TX("\n\nBattery Voltage: %d \n", app_bbu_get_battery_level());
@@ -430,6 +493,19 @@ static void handleBV(char* msg)  // Get Battery Voltage
 //     }
 }
 
+// A setting in use until reset when the EEPROM couldn't take it
+void app_uart_printSaveStatus(enum status_code status)
+{
+    if (STATUS_OK == status)
+    {
+        UART_TX("\tSaved\n");
+    }
+    else
+    {
+        UART_TX("NG Error - not saved to EEPROM (status 0x%02X), in use until reset\n", status);
+    }
+}
+
 void app_uart_printResetReason(uint8_t resetCause)
 {
     if (resetCause == SYSTEM_RESET_CAUSE_SOFTWARE)
@@ -478,12 +554,20 @@ static void handleGS(char* msg)
     UART_TX("\n\nGET STATUS:\r\r");
     app_uart_printResetReason(system_get_reset_cause());
 
+    StatusSnapshot_t snapshot;
     AlarmModuleStatus_t AM_Stat; 
-    PortStatus_t chanStat[CH_COUNT];
+    PortStatus_t chanStat;
     AlarmStatus_t alarmStat;
+    uint32_t posted;
+    uint32_t coalesced;
+    uint32_t dropped;
+
+    app_gen_io_get_snapshot(&snapshot);
+    UART_TX("\r\rSNAPSHOT: v%u seq %u at %lu ms\r", snapshot.version, snapshot.sequence,
+            (unsigned long)snapshot.uptimeMs);
 
  // System Status
-    AM_Stat.sAlarmModule = app_gen_io_get_AM_status();
+    AM_Stat.sAlarmModule = snapshot.sAlarmModule;
     
     UART_TX("\r\rSYSTEM STATUS:\r");
     UART_TX("\tAM Status: 0x%02x\r", AM_Stat.sAlarmModule);
@@ -509,7 +593,7 @@ static void handleGS(char* msg)
     UART_TX("\rCR: %d\r", printDebugData);
     
 // Arm Status 
-    alarmStat.sAlarm = app_arm_get_alarm_status();
+    alarmStat.sAlarm = snapshot.sAlarm;
         
     UART_TX("\rARM STATUS:\r");
     UART_TX("\r\tarmed: %c\r", (alarmStat.armed ? '1' : '0') );
@@ -519,18 +603,26 @@ static void handleGS(char* msg)
     UART_TX("\tpowerTamper_Alarm: %c\r", (alarmStat.powerTamper_Alarm ? '1' : '0') );
     UART_TX("\tdaisyChainTamper_Alarm: %c\r", (alarmStat.daisyChainTamper_Alarm ? '1' : '0') );
     UART_TX("\tdaisyChainTamper_Armed: %c\r", (alarmStat.daisyChainTamper_Armed ? '1' : '0') );
+    UART_TX("\tnotReady: 0x%08lx\r", (unsigned long)snapshot.notReady);
+    app_arm_get_alarm_event_stats(&posted, &coalesced, &dropped);
+    UART_TX("\talarm events: %lu posted, %lu coalesced, %lu dropped\r", (unsigned long)posted,
+            (unsigned long)coalesced, (unsigned long)dropped);
         
     
 // Fetch and display the Channel Data
     UART_TX("\rCHANNEL STATUS:\r");
+    UART_TX("\tedge ring overflows: %u\r", snapshot.edgeOverflows);
     for(int num = 0; num < CH_COUNT; num++)
     {
-        chanStat[num].sPort  = app_gen_io_get_Channel_Status(num);
-        UART_TX("\r\tChannel %d Status : 0x%02x\r", num, chanStat[num].sPort);  
-        UART_TX("\tcablePresent: %c\r", ( chanStat[num].cablePresent ? '1' : '0') );
-        //UART_TX("\tswitchClosed: %c\r", ( chanStat[num].switchClosed ? '1' : '0') );
-        UART_TX("\tarmed: %c\r", (chanStat[num].armed ? '1' : '0') );
-        UART_TX("\talarming: %c\r", (chanStat[num].alarming ? '1' : '0') );      
+        chanStat.sPort  = app_gen_io_snapshot_port_status(&snapshot, num);
+        UART_TX("\r\tChannel %d Status : 0x%02x\r", num, chanStat.sPort);  
+        UART_TX("\tcablePresent: %c\r", ( chanStat.cablePresent ? '1' : '0') );
+        //UART_TX("\tswitchClosed: %c\r", ( chanStat.switchClosed ? '1' : '0') );
+        UART_TX("\tarmed: %c\r", (chanStat.armed ? '1' : '0') );
+        UART_TX("\talarming: %c\r", (chanStat.alarming ? '1' : '0') );      
+        UART_TX("\tfault: %c\r", (chanStat.fault ? '1' : '0') );
+        UART_TX("\tedges: %u transitions: %u quarantined: %u\r", snapshot.edges[num],
+                snapshot.transitions[num], snapshot.quarantines[num]);
     }
     
     //Battery
@@ -541,6 +633,107 @@ static void handleGS(char* msg)
 
 }
 
+static void handleDC(char* msg)
+{
+    char tempStr[2];
+    memset(tempStr, '\0', sizeof(tempStr));
+    strncpy(tempStr, &msg[3], 1);
+    uint8_t channel = strtoul(tempStr, 0, 16) & 0x0F;
+    strncpy(tempStr, &msg[4], 1);
+    uint8_t profile = strtoul(tempStr, 0, 16) & 0x0F;
+    enum status_code status;
+
+    UART_TX("\n\nCHANNEL DEBOUNCE PROFILE:\n");
+
+    status = app_gen_io_set_channel_profile(channel, profile);
+
+    if (STATUS_ERR_INVALID_ARG == status)
+    {
+        UART_TX("\tInvalid channel or profile\n");
+    }
+    else
+    {
+        UART_TX("\tChannel %u: profile %u\n", channel, profile);
+        app_uart_printSaveStatus(status);
+    }
+}
+
+static void handleDL(char* msg)
+{
+    UART_TX("\n\nDEBOUNCE LATENCY (lift/press/qualify ms, latency us):\n");
+
+    for (uint8_t num = 0; num < CH_COUNT; num++)
+    {
+        uint8_t profileNum = app_gen_io_get_channel_profile(num);
+        const DebounceProfile_t* profile = app_gen_io_get_debounce_profile(profileNum);
+        const ChannelTiming_t* timing = app_gen_io_get_channel_timing(num);
+
+        UART_TX("\tChannel %u: profile %u %u/%u/%u, edges %u bounce %lu, report %lu max %lu, alarm %lu\n",
+                num, profileNum, profile->liftTime * DEBOUNCE_PROFILE_UNIT_MS,
+                profile->pressTime * DEBOUNCE_PROFILE_UNIT_MS, profile->qualifyTime * DEBOUNCE_PROFILE_UNIT_MS,
+                timing->bounceEdges, (unsigned long)timing->bounceUs, (unsigned long)timing->latencyUs,
+                (unsigned long)timing->maxLatencyUs, (unsigned long)timing->alarmLatencyUs);
+    }
+}
+
+static void handleDP(char* msg)
+{
+    DebounceProfile_t profile;
+    enum status_code status;
+    char tempStr[3];
+
+    memset(tempStr, '\0', sizeof(tempStr));
+    strncpy(tempStr, &msg[3], 1);
+    uint8_t profileNum = strtoul(tempStr, 0, 16) & 0x0F;
+
+    strncpy(tempStr, &msg[4], 2);
+    profile.liftTime = strtoul(tempStr, 0, 16) & 0xFF;
+    strncpy(tempStr, &msg[6], 2);
+    profile.pressTime = strtoul(tempStr, 0, 16) & 0xFF;
+    strncpy(tempStr, &msg[8], 2);
+    profile.qualifyTime = strtoul(tempStr, 0, 16) & 0xFF;
+
+    UART_TX("\n\nSET DEBOUNCE PROFILE:\n");
+
+    status = app_gen_io_set_debounce_profile(profileNum, &profile);
+
+    if (STATUS_ERR_INVALID_ARG == status)
+    {
+        UART_TX("\tInvalid profile, 0-%u\n", DEBOUNCE_PROFILE_COUNT - 1);
+    }
+    else
+    {
+        UART_TX("\tProfile %u: lift %u ms, press %u ms, qualify %u ms\n", profileNum,
+                profile.liftTime * DEBOUNCE_PROFILE_UNIT_MS, profile.pressTime * DEBOUNCE_PROFILE_UNIT_MS,
+                profile.qualifyTime * DEBOUNCE_PROFILE_UNIT_MS);
+        app_uart_printSaveStatus(status);
+    }
+}
+
+static void handleEF(char* msg)
+{
+    uint8_t ctrlByte = msg[3] - 48;  // Convert from ASCII
+    InputFilterStats_t stats;
+
+    UART_TX("\n\nEIC FILTER:\n");
+
+    if (ctrlByte <= 1)
+    {
+        app_gen_io_set_input_filter(ctrlByte);
+    }
+
+    UART_TX("\tChannel filter now %s\n", app_gen_io_get_input_filter() ? "ON" : "OFF");
+
+    // Spurious = edge interrupts that never became a debounced transition
+    for (uint8_t filter = 0; filter <= 1; filter++)
+    {
+        app_gen_io_get_input_filter_stats(filter, &stats);
+        UART_TX("\tFilter %s: %lu s, %lu edges, %lu transitions, %lu spurious\n", filter ? "ON " : "OFF",
+                (unsigned long)(stats.timeMs / 1000), (unsigned long)stats.edges, (unsigned long)stats.transitions,
+                (unsigned long)((stats.edges > stats.transitions) ? (stats.edges - stats.transitions) : 0));
+    }
+}
+
 static void handleGV(char* msg)
 {
     char modelNumber[MODEL_NUMBER_LEN + 1];
@@ -723,14 +916,165 @@ static void handleSW(char* msg)
  //   app_bootloader_data_handler(UPDATE_COMMAND_SWITCH, 0, 0, NULL);
 }
 
+static void handleTS(char* msg)
+{
+    uint32_t uptime = SYS_Timer_Time();
+    uint64_t uptimeUs = SYS_Timer_TimeUs();
+    uint32_t wakeups = hw_timer_get_wakeups();
+    uint32_t isrTime = hw_timer_get_isr_time_us();
+    SYS_TimerStats_t stats;
+
+    SYS_TimerGetStats(&stats);
+
+#ifdef HW_TIMER_TICKLESS
+    UART_TX("\nTIMER STATS (tickless):\n");
+#else
+    UART_TX("\nTIMER STATS (tick):\n");
+#endif
+    UART_TX("\tUptime: %lu.%06lu s\n", (unsigned long)(uptimeUs / 1000000), (unsigned long)(uptimeUs % 1000000));
+    UART_TX("\tBoot to Ready: %lu us\n", (unsigned long)app_gen_io_get_boot_ready_us());
+    UART_TX("\tWakeups: %lu\n", (unsigned long)wakeups);
+    UART_TX("\tISR Time: %lu us\n", (unsigned long)isrTime);
+    UART_TX("\tTask Timers: %u active, %lu fired, %lu ms max latency\n",
+            stats.active[SYS_TIMER_DOMAIN_TASK], (unsigned long)stats.fired[SYS_TIMER_DOMAIN_TASK],
+            (unsigned long)stats.maxLatency);
+    UART_TX("\tMain Loop: %lu ms max stall, %lu late task timers\n",
+            (unsigned long)stats.maxStall, (unsigned long)stats.late);
+    UART_TX("\tCoalesced Wakeups: %lu\n", (unsigned long)stats.coalesced);
+    UART_TX("\tSkipped Periods: %lu\n", (unsigned long)stats.skipped);
+    UART_TX("\tISR Timers: %u active, %lu fired\n",
+            stats.active[SYS_TIMER_DOMAIN_ISR], (unsigned long)stats.fired[SYS_TIMER_DOMAIN_ISR]);
+    if (uptime)
+    {
+        // Wakeups per second and ISR load in hundredths of a percent
+        UART_TX("\tWakeups/s: %lu\n", (unsigned long)(((uint64_t)wakeups * 1000) / uptime));
+        UART_TX("\tISR Load: %lu/10000\n", (unsigned long)(((uint64_t)isrTime * 10) / uptime));
+    }
+}
+
+
+
+
+#ifdef SYS_TIMER_PROFILE
+static void handleTP(char* msg)
+{
+    ChannelIsrProfile_t isr;
+
+    UART_TX("\nTIMER PROFILE (late ms: 0 1 2-3 4-7 8-15 16-31 32-63 64+):\n");
+
+    for (SYS_Timer_t* timer = SYS_TimerProfileFirst(); timer; timer = timer->prof.next)
+    {
+        uint32_t avgRun = timer->prof.fired ? (timer->prof.totalRun / timer->prof.fired) : 0;
+
+        const char* name = app_timers_get_name(timer);
+
+        // Timers outside the registry print their handler address, look it up in the .map file
+        if (name)
+        {
+            UART_TX("\t%-22s", name);
+        }
+        else
+        {
+            UART_TX("\t%08lX              ", (unsigned long)timer->handler);
+        }
+        UART_TX(" %s fired %lu, run avg %lu us max %lu us, late",
+                (SYS_TIMER_DOMAIN_ISR == timer->domain) ? "ISR " : "TASK",
+                (unsigned long)timer->prof.fired,
+                (unsigned long)(avgRun * 1000 / HW_TIMER_PERIOD),
+                (unsigned long)((uint32_t)timer->prof.maxRun * 1000 / HW_TIMER_PERIOD));
+        for (uint8_t i = 0; i < SYS_TIMER_PROFILE_BUCKETS; i++)
+        {
+            UART_TX(" %u", timer->prof.late[i]);
+        }
+        UART_TX("\n");
+    }
+    // The other half of the debounce path, GEN_IO_DEBOUNCE_SAMPLE above is the sample tick
+    app_gen_io_get_channel_isr_profile(&isr);
+    UART_TX("\tChannel ISR: %lu runs, avg %lu us max %lu us\n", (unsigned long)isr.runs,
+            (unsigned long)(isr.runs ? ((uint64_t)isr.totalCounts * 1000 / HW_TIMER_PERIOD / isr.runs) : 0),
+            (unsigned long)((uint32_t)isr.maxCounts * 1000 / HW_TIMER_PERIOD));
+}
+#endif
+
+static void handleZC(char* msg)
+{
+    char tempStr[4];
+    memset(tempStr, '\0', sizeof(tempStr));
+    strncpy(tempStr, &msg[3], 1);
+    uint8_t zone = strtoul(tempStr, 0, 16) & 0x0F;
+    strncpy(tempStr, &msg[4], 3);
+    uint16_t channels = strtoul(tempStr, 0, 16) & CH_ALL_MASK;
+
+    UART_TX("\n\nZONE CHANNELS:\n");
+
+    if (app_arm_assign_zone_channels(zone, channels))
+    {
+        UART_TX("\tZone %u: channels 0x%03x\n", zone, app_arm_get_zone_channels(zone));
+    }
+    else
+    {
+        UART_TX("\tInvalid zone (0-%u) or a zone involved is armed\n", ARM_ZONE_COUNT - 1);
+    }
+}
+
+static void handleZD(char* msg)
+{
+    char tempStr[2];
+    memset(tempStr, '\0', sizeof(tempStr));
+    strncpy(tempStr, &msg[3], 1);
+    uint8_t zone = strtoul(tempStr, 0, 16) & 0x0F;
+
+    UART_TX("\n\nZONE DISARM:\n");
+
+    if (zone < ARM_ZONE_COUNT)
+    {
+        app_arm_disarm_zone(zone);
+        UART_TX("\tZone %u disarmed\n", zone);
+    }
+    else
+    {
+        UART_TX("\tInvalid zone, 0-%u\n", ARM_ZONE_COUNT - 1);
+    }
+}
+
+static void handleZT(char* msg)
+{
+    char tempStr[5];
+    uint32_t autoArmMs;
+    uint32_t alarmLimitMs;
+
+    memset(tempStr, '\0', sizeof(tempStr));
+    strncpy(tempStr, &msg[3], 1);
+    uint8_t zone = strtoul(tempStr, 0, 16) & 0x0F;
+    strncpy(tempStr, &msg[4], 4);
+    autoArmMs = strtoul(tempStr, 0, 16) * 1000ul;
+    strncpy(tempStr, &msg[8], 4);
+    alarmLimitMs = strtoul(tempStr, 0, 16) * 1000ul;
 
+    UART_TX("\n\nZONE TIMES:\n");
 
+    if (app_arm_set_zone_times(zone, autoArmMs, alarmLimitMs))
+    {
+        app_arm_get_zone_times(zone, &autoArmMs, &alarmLimitMs);
+        UART_TX("\tZone %u: auto-arm %lu s, alarm limit %lu s\n", zone, (unsigned long)(autoArmMs / 1000),
+                (unsigned long)(alarmLimitMs / 1000));
+    }
+    else
+    {
+        UART_TX("\tInvalid zone (0-%u) or zero time\n", ARM_ZONE_COUNT - 1);
+    }
+}
 
 static void handleQM(char* msg)  // HELP
 {
     UART_TX("\n");
+    UART_TX("AT - Arm state machine Trace\n");
     UART_TX("BV - Battery Voltage\n");
     UART_TX("CR - Print debug data to UART\n");
+    UART_TX("DC <C><P> - Set Channel C to Debounce Profile P\n");
+    UART_TX("DL - Debounce Latency per Channel\n");
+    UART_TX("DP <P><LL><PP><QQ> - Set Debounce Profile P, lift/press/qualify in 10 ms\n");
+    UART_TX("EF <N> - Channel EIC Filter off (0) / on (1), other N just reports spurious edges\n");
     UART_TX("FF - Free Function (placeholder)\n");
     UART_TX("GS - Get Status\n");
     UART_TX("GV - Get Version\n");
@@ -738,6 +1082,13 @@ static void handleQM(char* msg)  // HELP
     UART_TX("RB <N> - Reboot");
     UART_TX("SA <N> - Set Arm/Disarm\n");
     UART_TX("SH <VV><AA><SS> - Set User Config\n");
+    UART_TX("TS - Timer Stats\n");
+#ifdef SYS_TIMER_PROFILE
+    UART_TX("TP - Timer Profile\n");
+#endif
+    UART_TX("ZC <Z><MMM> - Move Channel mask MMM to Zone Z, zones must be disarmed\n");
+    UART_TX("ZD <Z> - Disarm Zone Z\n");
+    UART_TX("ZT <Z><AAAA><LLLL> - Set Zone Z auto-arm and alarm limit times in seconds\n");
     UART_TX("?? - Help\n");
     UART_TX("\n");
 }
@@ -811,7 +1162,7 @@ void app_uart_disable(void)
     usart_disable_callback(&usart_instance, USART_CALLBACK_BUFFER_RECEIVED);
     usart_disable_callback(&usart_instance, USART_CALLBACK_ERROR);
 
-    SYS_TimerStop(&dmaTimer);
+    SYS_TimerStop(APP_TIMER(UART_DMA));
     dma_abort_job(&usart_dma_resource_rx);
     dma_disable_callback(&usart_dma_resource_rx, DMA_CALLBACK_TRANSFER_DONE);
     dma_free(&usart_dma_resource_rx);
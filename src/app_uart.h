@@ -14,6 +14,7 @@
 #define RX_BUFFER_SIZE       DMA_BUFFER_SIZE
 #define COMMAND_LENGTH       2
 #define TX_BUFFER_LENGTH     CIRC_BUFFER_SIZE
+#define USART_INIT_RETRIES   1000  // usart_init() attempts before boot goes on without the debug UART
 
 void app_uart_task(void);
 void app_arraySN_to_strSN(uint8_t *strSN, uint8_t *arraySN);
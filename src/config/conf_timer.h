@@ -17,6 +17,30 @@
 #define HW_TIMER_MODULE        TC3
 #define HW_TIME_RUN_IN_STANDBY true
 
+// SYS timers are hashed into a timing wheel by deadline. Each slot is kept sorted
+// by deadline, so a tick only looks at due timers and stop is O(1); start walks
+// the few timers sharing its slot. Must be a power of two; each slot costs one
+// pointer of RAM.
+#define SYS_TIMER_WHEEL_SLOTS  64
+
+// Uncomment to run TC3 free running and interrupt only at the next SYS/SLP
+// deadline instead of every HW_TIMER_INTERVAL. The counter wraps every 524ms
+// so the compare is never programmed further out than HW_TIMER_TICKLESS_MAX_MS.
+//#define HW_TIMER_TICKLESS
+#define HW_TIMER_TICKLESS_MAX_MS     500ul /* ms */
+#define HW_TIMER_TICKLESS_MIN_COUNTS 4     /* counts ahead of TC3 when pulled in */
+// Tickless mode keeps the started timers in a min-heap by deadline plus slack
+// so the next wakeup is known without a scan. Timers started beyond this many
+// fall back to waking every HW_TIMER_INTERVAL until there is room again. Must
+// be below 255.
+#define SYS_TIMER_HEAP_SIZE          48
+
+// Uncomment to record per timer fire counts, lateness histograms and handler
+// run time, plus the channel interrupt run time (TP UART command). Costs about
+// 40 bytes of RAM per timer and two TC3 count syncs per channel interrupt.
+//#define SYS_TIMER_PROFILE
+#define SYS_TIMER_PROFILE_BUCKETS    8
+
 // If timers are started or stopped from interrupt this must be defined
 #define HW_TIMER_ENTER_CRITICAL cpu_irq_enter_critical();
 #define HW_TIMER_LEAVE_CRITICAL cpu_irq_leave_critical();
@@ -25,11 +49,15 @@
 #include "config.h"
 
 /*
- * - SYS timer handlers are called from the main loop
+ * - SYS timer handlers are called from the main loop (SYS_TIMER_DOMAIN_TASK)
  * - SLP timer handlers are called from interrupt and will operate in all sleep modes
+ *   (SYS_TIMER_DOMAIN_ISR)
+ * - Both share one timer wheel, advanced from the hw timer interrupt
  *
  * - Example usage
  * - SYS and/or SLP timers can be used
+ * - Timers whose interval, mode and handler never change are registered in
+ *   APP_TIMER_LIST (app_timers.h) and used as APP_TIMER(ID) instead
  *
  * - SYS Timer usage
  * - #include "sysTimer.h"
@@ -44,6 +72,7 @@
  *   }
  *
  *   testTimer.interval = 1000; // Initialize specific timer
+ *   testTimer.slack = 50; // Optional, may run up to 50ms late to share a wakeup (tickless only)
  *   testTimer.mode = SYS_TIMER_INTERVAL_MODE;
  *   testTimer.handler = testTimerHandler;
  *   SYS_TimerStart(&testTimer); // Start timer for specific timer
@@ -52,7 +81,7 @@
  *
  * - SLP Timer usage
  * - #include "slpTimer.h"
- * - SLP_TimerInit(); // Call during main initialization code
+ * - SLP timers are SYS timers with domain SYS_TIMER_DOMAIN_ISR, no separate init
  *
  * - static SLP_Timer_t testTimer; //  Global variable for specific timer
  * - static void testTimerHandler(SLP_Timer_t *timer) // Timer expiration callback handler
@@ -62,9 +91,9 @@
  *   }
  *
  *   testTimer.interval = 1000; // Initialize specific timer
- *   testTimer.mode = SYS_TIMER_INTERVAL_MODE;
+ *   testTimer.mode = SLP_TIMER_INTERVAL_MODE;
  *   testTimer.handler = testTimerHandler;
- *   SLP_TimerStart(&testTimer); // Start timer for specific timer
+ *   SLP_TimerStart(&testTimer); // Start timer for specific timer, sets the ISR domain
  *
  */
 
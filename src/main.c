@@ -45,16 +45,28 @@
 
 int main (void)
 {
+    uint32_t bootCycles;
+    
+    // Boot is timed from here. SysTick counts CPU cycles until the hw timer takes over,
+    // delay_init() only sets the CTRL bits already set here.
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    
 	system_init();
     delay_init();
     sleepmgr_init();
+    
+    // Cycles before system_init() switched OSC8M to DIV_1 ran at 1 MHz and are
+    // under-counted, that is the clock setup only
+    bootCycles = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
     SYS_TimerInit();
-    SLP_TimerInit();
+    app_gen_io_set_boot_start_us(bootCycles / (system_cpu_clock_get_hz() / 1000000));
  
 //    app_eeprom_init();
-    app_gen_io_init();  // Need to start the timers before we start the IO
+    app_gen_io_init();  // Need to start the timers before we start the IO, inputs settle on a timer
 //     app_LED_init();
-    app_daisychain_init();
+//    app_daisychain_init();  // Started by app_gen_io once nMASTER has settled
     app_uart_enable();
     app_buzzer_init();
 // //    app_user_options_init();
@@ -62,9 +74,7 @@ int main (void)
 //     app_bbu_init();
     cpu_irq_enable();
     app_wdt_enable();
-    // After all the rest of the initialization, start the auto-arm
-    // timer, just in case everything is ready.
-    app_arm_reset_auto_arm_timer();
+    // The auto-arm timer is restarted by app_gen_io once the cables have been sampled
     
     while(true)
     {
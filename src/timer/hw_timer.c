@@ -7,31 +7,113 @@
 #include "tc_interrupt.h"
 #include "hw_timer.h"
 #include "sysTimer.h"
-#include "slpTimer.h"
 
 struct tc_config timer_config;
 struct tc_module module_inst;
 
+static volatile uint32_t hwTimerWakeups;
+static volatile uint32_t hwTimerIsrCounts;
+static volatile uint16_t lastCount;     // Counter value of the last whole ms delivered
+static volatile uint32_t armedMs;       // Compare target, in ms past lastCount
+static volatile uint64_t lastMs;        // Whole ms delivered since init, never wraps
+
+
+/*! \brief  program CC0 to match ms past lastCount. The match is pushed out
+ *          to at least margin counts from now so it cannot be missed.
+ */
+static void hw_timer_arm(uint32_t ms, uint16_t margin)
+{
+	uint16_t count = tc_get_count_value(&module_inst);
+
+	if (ms > HW_TIMER_TICKLESS_MAX_MS) {
+		ms = HW_TIMER_TICKLESS_MAX_MS;
+	}
+
+	while (ms * HW_TIMER_PERIOD < (uint32_t)(uint16_t)(count - lastCount) + margin) {
+		ms += HW_TIMER_INTERVAL;
+	}
+
+	armedMs = ms;
+	tc_set_compare_value(&module_inst, TC_COMPARE_CAPTURE_CHANNEL_0,
+			(uint16_t)(lastCount + ms * HW_TIMER_PERIOD));
+}
+
+/*! \brief  whole ms elapsed on the counter that have not been delivered to
+ *          the SYS expiry callback yet
+ */
+uint32_t hw_timer_elapsed(void)
+{
+	uint16_t count = tc_get_count_value(&module_inst);
+
+	return (uint16_t)(count - lastCount) / HW_TIMER_PERIOD;
+}
+
+#ifdef HW_TIMER_TICKLESS
+/*! \brief  make sure the hw timer interrupts no later than ms past the last
+ *          delivered expiry. Called when a timer is placed.
+ */
+void hw_timer_request(uint32_t ms)
+{
+	cpu_irq_enter_critical();
+
+	if (ms < armedMs) {
+		hw_timer_arm(ms, HW_TIMER_TICKLESS_MIN_COUNTS);
+	}
+
+	cpu_irq_leave_critical();
+}
+#endif
 
 /*! \brief  hw timer compare callback
+ *
+ * The counter runs free and elapsed time is taken from the difference to
+ * the last delivered count, so a late or missed interrupt loses no time.
  */
 static void hw_timer_callback(struct tc_module *const module_instance)
 {
-	SYS_HwExpiry_Cb();
-	SLP_HwExpiry_Cb();
-	
+	uint16_t entry = tc_get_count_value(&module_inst);
+	uint32_t elapsed;
+	uint32_t next;
+
+	hwTimerWakeups++;
+
+	elapsed = hw_timer_elapsed();
+	lastCount += elapsed * HW_TIMER_PERIOD;
+	lastMs += elapsed;
+
+	if (elapsed) {
+		SYS_HwExpiry_Cb(elapsed);
+
 #ifdef EXT_HW_EXPIRY_CB
-	EXT_HW_EXPIRY_CB();
+		EXT_HW_EXPIRY_CB();
 #endif
+	}
+
+	// The match flag is cleared after this callback returns, so the next
+	// match must land comfortably after that
+	cpu_irq_enter_critical();
+
+#ifdef HW_TIMER_TICKLESS
+	next = SYS_TimerNextExpiry();
+#else
+	next = HW_TIMER_INTERVAL;
+#endif
+	hw_timer_arm(next, HW_TIMER_PERIOD / 2);
+
+	cpu_irq_leave_critical();
+
+	hwTimerIsrCounts += (uint16_t)(tc_get_count_value(&module_inst) - entry);
 }
 
-/*! \brief  initialize hw timer to cause interrupt every HW_TIMER_INTERVAL
+/*! \brief  initialize hw timer to cause interrupt every HW_TIMER_INTERVAL,
+ *          or at the next timer deadline when HW_TIMER_TICKLESS is defined
  */
 void hw_timer_init(void)
 {
 	tc_get_config_defaults(&timer_config);
 	timer_config.run_in_standby = HW_TIME_RUN_IN_STANDBY;
-	timer_config.wave_generation = TC_WAVE_GENERATION_MATCH_FREQ;
+	// Free running counter, CC0 is moved ahead at every match
+	timer_config.wave_generation = TC_WAVE_GENERATION_NORMAL_FREQ;
 	timer_config.clock_source = HW_TIMER_SOURCE;
 	timer_config.clock_prescaler = HW_TIMER_PRESCALER;
 	timer_config.counter_16_bit.compare_capture_channel[0] = HW_TIMER_PERIOD;
@@ -39,5 +121,48 @@ void hw_timer_init(void)
 	tc_register_callback(&module_inst, hw_timer_callback, TC_CALLBACK_CC_CHANNEL0);
 	tc_enable_callback(&module_inst, TC_CALLBACK_CC_CHANNEL0);
 
+	hwTimerWakeups = 0;
+	hwTimerIsrCounts = 0;
+	lastCount = 0;
+	lastMs = 0;
+	armedMs = HW_TIMER_INTERVAL;
+
 	tc_enable(&module_inst);
 }
+
+/*! \brief  free running hw timer count, HW_TIMER_PERIOD counts per ms
+ */
+uint16_t hw_timer_get_count(void)
+{
+	return tc_get_count_value(&module_inst);
+}
+
+/*! \brief  monotonic time since init in microseconds, 8us resolution.
+ *          Safe to call from interrupt.
+ */
+uint64_t hw_timer_get_time_us(void)
+{
+	uint64_t ms;
+	uint16_t counts;
+
+	cpu_irq_enter_critical();
+	ms = lastMs;
+	counts = tc_get_count_value(&module_inst) - lastCount;
+	cpu_irq_leave_critical();
+
+	return (ms * 1000) + (((uint32_t)counts * 1000) / HW_TIMER_PERIOD);
+}
+
+/*! \brief  number of hw timer interrupts since init
+ */
+uint32_t hw_timer_get_wakeups(void)
+{
+	return hwTimerWakeups;
+}
+
+/*! \brief  time spent in the hw timer interrupt since init, in microseconds
+ */
+uint32_t hw_timer_get_isr_time_us(void)
+{
+	return (uint32_t)(((uint64_t)hwTimerIsrCounts * 1000) / HW_TIMER_PERIOD);
+}
@@ -11,6 +11,15 @@
 
 
 void hw_timer_init(void);
+uint32_t hw_timer_get_wakeups(void);
+uint32_t hw_timer_get_isr_time_us(void);
+uint32_t hw_timer_elapsed(void);
+uint16_t hw_timer_get_count(void);
+uint64_t hw_timer_get_time_us(void);
+
+#ifdef HW_TIMER_TICKLESS
+void hw_timer_request(uint32_t ms);
+#endif
 
 
 #endif /* HW_TIMER_H */
@@ -9,38 +9,43 @@
 #ifndef SLPTIMER_H_
 #define SLPTIMER_H_
 
+/*
+ * SLP timers are SYS timers in the interrupt domain. They share the SYS
+ * timer wheel and tick, and their handlers are called from the hw timer
+ * interrupt so they keep running in all sleep modes.
+ */
 
 /*- Includes ---------------------------------------------------------------*/
-#include <stdint.h>
-#include <stdbool.h>
-#include <stdlib.h>
-#include "compiler.h"
+#include "sysTimer.h"
 
 /*- Types ------------------------------------------------------------------*/
-typedef enum SLP_TimerMode_t {
-	SLP_TIMER_INTERVAL_MODE,
-	SLP_TIMER_PERIODIC_MODE,
-} SLP_TimerMode_t;
-
-typedef struct SLP_Timer_t {
-	/* Internal data */
-	struct SLP_Timer_t *next;
-	uint32_t timeout;
-
-	/* Timer parameters */
-	uint32_t interval;
-	SLP_TimerMode_t mode;
-	void (*handler)(struct SLP_Timer_t *timer);
-} SLP_Timer_t;
+typedef SYS_TimerMode_t SLP_TimerMode_t;
+typedef SYS_Timer_t SLP_Timer_t;
+
+#define SLP_TIMER_INTERVAL_MODE     SYS_TIMER_INTERVAL_MODE
+#define SLP_TIMER_PERIODIC_MODE     SYS_TIMER_PERIODIC_MODE
+
+#define SLP_TIMER_INIT(_interval, _mode, _handler) \
+	{ .interval = (_interval), .mode = (_mode), .domain = SYS_TIMER_DOMAIN_ISR, .handler = (_handler) }
 
 /*- Prototypes -------------------------------------------------------------*/
-void SLP_TimerInit(void);
-void SLP_TimerStart(SLP_Timer_t *timer);
-void SLP_TimerRestart(SLP_Timer_t *timer);
-void SLP_TimerStop(SLP_Timer_t *timer);
-bool SLP_TimerStarted(SLP_Timer_t *timer);
-uint32_t SLP_TimerTimeout(SLP_Timer_t *timer);
-void SLP_HwExpiry_Cb(void);
-uint32_t SLP_Timer_Time(void);
-
-#endif /* SLPTIMER_H_ */
\ No newline at end of file
+static inline void SLP_TimerStart(SLP_Timer_t *timer)
+{
+	timer->domain = SYS_TIMER_DOMAIN_ISR;
+	SYS_TimerStart(timer);
+}
+
+static inline void SLP_TimerRestart(SLP_Timer_t *timer)
+{
+	SYS_TimerStop(timer);
+	timer->domain = SYS_TIMER_DOMAIN_ISR;
+	SYS_TimerStart(timer);
+}
+
+#define SLP_TimerStop(timer)        SYS_TimerStop(timer)
+#define SLP_TimerStarted(timer)     SYS_TimerStarted(timer)
+#define SLP_TimerTimeout(timer)     SYS_TimerTimeout(timer)
+#define SLP_Timer_Time()            SYS_Timer_Time()
+#define SLP_Timer_TimeUs()          SYS_Timer_TimeUs()
+
+#endif /* SLPTIMER_H_ */
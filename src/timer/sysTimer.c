@@ -51,26 +51,105 @@
 #include "sysTimer.h"
 
 
+/*- Definitions ------------------------------------------------------------*/
+#define SYS_TIMER_WHEEL_MASK   (SYS_TIMER_WHEEL_SLOTS - 1)
+
+#if (SYS_TIMER_WHEEL_SLOTS & SYS_TIMER_WHEEL_MASK)
+	#error "SYS_TIMER_WHEEL_SLOTS must be a power of two"
+#endif
+
+#ifdef HW_TIMER_TICKLESS
+	#if (SYS_TIMER_HEAP_SIZE >= 255)
+		#error "SYS_TIMER_HEAP_SIZE must be below 255"
+	#endif
+	#define SYS_TIMER_HEAP_MISSING  0xFF   // heapPos of a wheel timer that didn't fit
+#endif
+
 /*****************************************************************************
 *****************************************************************************/
-static void placeTimer(SYS_Timer_t *timer);
+static void placeTimer(SYS_Timer_t *timer, uint32_t now);
+static void unlinkTimer(SYS_Timer_t *timer);
+static SYS_Timer_t *popExpiredTimer(uint32_t now);
+static SYS_Timer_t *popPendingTimer(void);
+#ifdef HW_TIMER_TICKLESS
+static void heapInsert(SYS_Timer_t *timer);
+static void heapRemove(SYS_Timer_t *timer);
+#endif
+#ifdef INCLUDE_ALL_DEBUG_FUNCTIONS
+static bool sysTimerListed(SYS_Timer_t *timer);
+#endif
+#ifdef SYS_TIMER_PROFILE
+static void profileRecord(SYS_Timer_t *timer, uint32_t now, uint16_t start);
+#endif
 
 /*- Variables --------------------------------------------------------------*/
-volatile uint8_t SysTimerIrqCount;
-static uint32_t SysTimerTime;
-static SYS_Timer_t *timers;
+static volatile uint32_t SysTimerTime;
+static SYS_Timer_t *wheel[SYS_TIMER_WHEEL_SLOTS];
+static SYS_Timer_t *pendingHead;       // Expired task timers, oldest first
+static SYS_Timer_t **pendingTail;
+static SYS_TimerStats_t sysTimerStats;
+static uint32_t lastTaskTime;         // SysTimerTime at the last SYS_TimerTaskHandler() call
+static uint32_t sysTimerExpired;      // Timers taken off the wheel, both domains
+#ifdef HW_TIMER_TICKLESS
+static SYS_Timer_t *heap[SYS_TIMER_HEAP_SIZE];  // Wheel timers, earliest wakeup at [0]
+static uint8_t heapCount;
+static uint16_t heapMissing;          // Wheel timers that didn't fit in the heap
+#endif
+#ifdef SYS_TIMER_PROFILE
+static SYS_Timer_t *profiled;         // Timers that have fired, most recent first
+#endif
 
 
 /*- Implementations --------------------------------------------------------*/
 
+/*************************************************************************//**
+*****************************************************************************/
+static inline uint32_t sysTimerNow(void)
+{
+	// Plus the ticks still in the counter
+	return SysTimerTime + hw_timer_elapsed();
+}
+
+/*************************************************************************//**
+*****************************************************************************/
+static inline uint32_t sysTimerWake(SYS_Timer_t *timer)
+{
+	// Latest time the hw timer has to wake up for this timer. Keying the
+	// deadline heap on this lets a timer with slack wait for a later one.
+	return timer->expires + timer->slack;
+}
+
 /*************************************************************************//**
 *****************************************************************************/
 void SYS_TimerInit(void)
 {
-	SysTimerIrqCount = 0;
 	SysTimerTime = 0;
+
+	for (uint16_t i = 0; i < SYS_TIMER_WHEEL_SLOTS; i++) {
+		wheel[i] = NULL;
+	}
+	pendingHead = NULL;
+	pendingTail = &pendingHead;
+#ifdef HW_TIMER_TICKLESS
+	heapCount = 0;
+	heapMissing = 0;
+#endif
+
+	for (uint8_t i = 0; i < SYS_TIMER_DOMAIN_COUNT; i++) {
+		sysTimerStats.fired[i] = 0;
+		sysTimerStats.active[i] = 0;
+	}
+	sysTimerStats.maxLatency = 0;
+	sysTimerStats.maxStall = 0;
+	sysTimerStats.late = 0;
+	sysTimerStats.coalesced = 0;
+	sysTimerStats.skipped = 0;
+#ifdef SYS_TIMER_PROFILE
+	profiled = NULL;
+#endif
+	lastTaskTime = 0;
+
 	hw_timer_init();
-	timers = NULL;
 }
 
 /*************************************************************************//**
@@ -82,7 +161,7 @@ void SYS_TimerStart(SYS_Timer_t *timer)
 	#endif
 
 	if (!SYS_TimerStarted(timer)) {
-		placeTimer(timer);
+		placeTimer(timer, sysTimerNow());
 	}
 
 	#ifdef HW_TIMER_LEAVE_CRITICAL
@@ -99,9 +178,9 @@ void SYS_TimerRestart(SYS_Timer_t *timer)
 	#endif
 
 	if (SYS_TimerStarted(timer)) {
-		SYS_TimerStop(timer);
+		unlinkTimer(timer);
 	}
-	placeTimer(timer);
+	placeTimer(timer, sysTimerNow());
 
 	#ifdef HW_TIMER_LEAVE_CRITICAL
 		HW_TIMER_LEAVE_CRITICAL
@@ -112,28 +191,12 @@ void SYS_TimerRestart(SYS_Timer_t *timer)
 *****************************************************************************/
 void SYS_TimerStop(SYS_Timer_t *timer)
 {
-	SYS_Timer_t *prev = NULL;
-
 	#ifdef HW_TIMER_ENTER_CRITICAL
 		HW_TIMER_ENTER_CRITICAL
 	#endif
 
-	for (SYS_Timer_t *t = timers; t; t = t->next) {
-		if (t == timer) {
-			if (prev) {
-				prev->next = t->next;
-			} else {
-				timers = t->next;
-			}
-
-			if (t->next) {
-				t->next->timeout += timer->timeout;
-			}
-
-			break;
-		}
-
-		prev = t;
+	if (SYS_TimerStarted(timer)) {
+		unlinkTimer(timer);
 	}
 
 	#ifdef HW_TIMER_LEAVE_CRITICAL
@@ -145,126 +208,201 @@ void SYS_TimerStop(SYS_Timer_t *timer)
 *****************************************************************************/
 bool SYS_TimerStarted(SYS_Timer_t *timer)
 {
-	#ifdef HW_TIMER_ENTER_CRITICAL
-		HW_TIMER_ENTER_CRITICAL
-	#endif
+	// A timer is linked into a wheel slot or the pending list if and only if pprev is set
+#ifdef INCLUDE_ALL_DEBUG_FUNCTIONS
+	Assert((NULL != timer->pprev) == sysTimerListed(timer));
+#endif
 
-	for (SYS_Timer_t *t = timers; t; t = t->next) {
-		if (t == timer) {
-			
-			#ifdef HW_TIMER_LEAVE_CRITICAL
-				HW_TIMER_LEAVE_CRITICAL
-			#endif
-
-			return true;
-		}
-	}
-
-	#ifdef HW_TIMER_LEAVE_CRITICAL
-		HW_TIMER_LEAVE_CRITICAL
-	#endif
-
-	return false;
+	return (NULL != timer->pprev);
 }
 
 /*************************************************************************//**
 *****************************************************************************/
 void SYS_TimerTaskHandler(void)
 {
-	uint32_t elapsed;
-	uint8_t cnt;
+	SYS_Timer_t *timer;
+	uint32_t now = SysTimerTime;
+
+	// Longest the main loop went without getting here
+	if (now - lastTaskTime > sysTimerStats.maxStall) {
+		sysTimerStats.maxStall = now - lastTaskTime;
+	}
+	lastTaskTime = now;
 
-	if (0 == SysTimerIrqCount) {
+	if (NULL == pendingHead) {
 		return;
 	}
 
-	cpu_irq_enter_critical();
-	cnt = SysTimerIrqCount;
-	SysTimerIrqCount = 0;
-	cpu_irq_leave_critical();
+#ifdef INCLUDE_ALL_DEBUG_FUNCTIONS
+	Assert(SYS_TimerCheck());
+#endif
+
+	// Task timers expired by the interrupt, in deadline order. After a stall
+	// this catches up on every overdue timer, oldest deadline first.
+	while ((timer = popPendingTimer()) != NULL) {
+#ifdef SYS_TIMER_PROFILE
+		uint32_t late = sysTimerNow();
+		uint16_t start = hw_timer_get_count();
+#endif
+
+		if (timer->handler) {
+			timer->handler(timer);
+		}
+
+#ifdef SYS_TIMER_PROFILE
+		profileRecord(timer, late, start);
+#endif
+	}
+}
 
-	elapsed = cnt * HW_TIMER_INTERVAL;
-	SysTimerTime += (cnt * HW_TIMER_INTERVAL);
+/*************************************************************************//**
+*****************************************************************************/
+static SYS_Timer_t *popPendingTimer(void)
+{
+	SYS_Timer_t *timer;
 
 	#ifdef HW_TIMER_ENTER_CRITICAL
 		HW_TIMER_ENTER_CRITICAL
 	#endif
 
-	while (timers && (timers->timeout <= elapsed)) {
-		SYS_Timer_t *timer = timers;
+	timer = pendingHead;
+	if (timer) {
+		if (SysTimerTime - timer->expires > sysTimerStats.maxLatency) {
+			sysTimerStats.maxLatency = SysTimerTime - timer->expires;
+		}
+		if (SysTimerTime - timer->expires > HW_TIMER_INTERVAL) {
+			sysTimerStats.late++;
+		}
+		sysTimerStats.fired[SYS_TIMER_DOMAIN_TASK]++;
+#ifdef SYS_TIMER_PROFILE
+		timer->prof.deadline = timer->expires;
+#endif
 
-		
-		elapsed -= timers->timeout;
-		timers = timers->next;
+		unlinkTimer(timer);
 		if (SYS_TIMER_PERIODIC_MODE == timer->mode) {
-			placeTimer(timer);
+			// Keep the cadence of the deadline, not of the main loop
+			placeTimer(timer, timer->expires);
 		}
+	}
 
-	
 	#ifdef HW_TIMER_LEAVE_CRITICAL
 		HW_TIMER_LEAVE_CRITICAL
 	#endif
-	
-		if (timer->handler) {
-			timer->handler(timer);
-		}
-		
+
+	return timer;
+}
+
+/*************************************************************************//**
+*****************************************************************************/
+static SYS_Timer_t *popExpiredTimer(uint32_t now)
+{
+	SYS_Timer_t *timer;
+
 	#ifdef HW_TIMER_ENTER_CRITICAL
 		HW_TIMER_ENTER_CRITICAL
 	#endif
-		
-	}
 
-	if (timers) {
-		timers->timeout -= elapsed;
-	}
+	do {
+		// Slots are sorted by deadline, so only the head can be due. Timers of a
+		// later revolution sit behind it and are never looked at here.
+		timer = wheel[now & SYS_TIMER_WHEEL_MASK];
+		if (timer && ((int32_t)(timer->expires - now) > 0)) {
+			timer = NULL;
+		}
+
+		if (timer) {
+			unlinkTimer(timer);
+			sysTimerExpired++;
+
+			if (SYS_TIMER_DOMAIN_TASK == timer->domain) {
+				// Queued for SYS_TimerTaskHandler(), still counts as started
+				timer->next = NULL;
+				timer->pprev = pendingTail;
+				*pendingTail = timer;
+				pendingTail = &timer->next;
+				sysTimerStats.active[SYS_TIMER_DOMAIN_TASK]++;
+			} else {
+				sysTimerStats.fired[SYS_TIMER_DOMAIN_ISR]++;
+#ifdef SYS_TIMER_PROFILE
+				timer->prof.deadline = timer->expires;
+#endif
+				if (SYS_TIMER_PERIODIC_MODE == timer->mode) {
+					placeTimer(timer, timer->expires);
+				}
+				break;
+			}
+		}
+	} while (timer);
 
 	#ifdef HW_TIMER_LEAVE_CRITICAL
 		HW_TIMER_LEAVE_CRITICAL
 	#endif
+
+	return timer;
 }
 
 /*************************************************************************//**
 *****************************************************************************/
-static void placeTimer(SYS_Timer_t *timer)
+static void placeTimer(SYS_Timer_t *timer, uint32_t now)
 {
-	#ifdef HW_TIMER_ENTER_CRITICAL
-		HW_TIMER_ENTER_CRITICAL
-	#endif
+	SYS_Timer_t **slot;
+	// A zero interval still has to wait for the next tick, as it did in the delta list
+	uint32_t period = timer->interval ? timer->interval : HW_TIMER_INTERVAL;
 
-	if (timers) {
-		SYS_Timer_t *prev = NULL;
-		uint32_t timeout = timer->interval;
+	// Periodic timers are placed from their previous deadline, never from
+	// when they were handled, so lateness does not accumulate
+	timer->expires = now + period;
 
-		for (SYS_Timer_t *t = timers; t; t = t->next) {
-			if (timeout < t->timeout) {
-				t->timeout -= timeout;
-				break;
-			} else {
-				timeout -= t->timeout;
-			}
+	// Deadlines the task handler fell behind on are skipped, keeping the phase
+	if ((int32_t)(timer->expires - SysTimerTime) <= 0) {
+		uint32_t missed = (SysTimerTime - timer->expires) / period + 1;
 
-			prev = t;
-		}
+		timer->expires += missed * period;
+		sysTimerStats.skipped += missed;
+	}
 
-		timer->timeout = timeout;
+	// Keep the slot sorted by deadline, equal deadlines fire in the order they were placed
+	slot = &wheel[timer->expires & SYS_TIMER_WHEEL_MASK];
+	while (*slot && ((int32_t)((*slot)->expires - timer->expires) <= 0)) {
+		slot = &(*slot)->next;
+	}
 
-		if (prev) {
-			timer->next = prev->next;
-			prev->next = timer;
-		} else {
-			timer->next = timers;
-			timers = timer;
-		}
-	} else {
-		timer->next = NULL;
-		timer->timeout = timer->interval;
-		timers = timer;
+	timer->next = *slot;
+	if (timer->next) {
+		timer->next->pprev = &timer->next;
 	}
+	timer->pprev = slot;
+	*slot = timer;
 
-	#ifdef HW_TIMER_LEAVE_CRITICAL
-		HW_TIMER_LEAVE_CRITICAL
-	#endif
+	sysTimerStats.active[timer->domain]++;
+
+#ifdef HW_TIMER_TICKLESS
+	heapInsert(timer);
+	hw_timer_request(sysTimerWake(timer) - SysTimerTime);
+#endif
+}
+
+/*************************************************************************//**
+*****************************************************************************/
+static void unlinkTimer(SYS_Timer_t *timer)
+{
+#ifdef HW_TIMER_TICKLESS
+	heapRemove(timer);
+#endif
+
+	if (pendingTail == &timer->next) {
+		pendingTail = timer->pprev;
+	}
+
+	*timer->pprev = timer->next;
+	if (timer->next) {
+		timer->next->pprev = timer->pprev;
+	}
+
+	timer->next = NULL;
+	timer->pprev = NULL;
+
+	sysTimerStats.active[timer->domain]--;
 }
 
 /*************************************************************************//**
@@ -272,38 +410,329 @@ static void placeTimer(SYS_Timer_t *timer)
 uint32_t SYS_TimerTimeout(SYS_Timer_t *timer)
 {
 	uint32_t timeout = 0;
+	uint32_t now;
 
 	#ifdef HW_TIMER_ENTER_CRITICAL
 		HW_TIMER_ENTER_CRITICAL
 	#endif
 
-	if (timers)
+	now = sysTimerNow();
+	if (SYS_TimerStarted(timer) && ((int32_t)(timer->expires - now) > 0))
 	{
-		for (SYS_Timer_t *t = timers; t; t = t->next)
-		{
-			timeout += t->timeout;
-			if (t == timer)
-			{
-				break;
-			}
-		}
+		timeout = timer->expires - now;
 	}
-	
+
 	#ifdef HW_TIMER_LEAVE_CRITICAL
 		HW_TIMER_LEAVE_CRITICAL
 	#endif
-	
+
 	return timeout;
 }
 
 /*****************************************************************************
 *****************************************************************************/
-void SYS_HwExpiry_Cb(void)
+void SYS_HwExpiry_Cb(uint32_t elapsed)
+{
+	uint16_t deadlines = 0;
+#ifdef SYS_TIMER_PROFILE
+	uint32_t wake = SysTimerTime + elapsed;    // Real time of this wakeup
+#endif
+
+	// Advance the wheel one slot per elapsed tick. Interrupt timers are
+	// called here, task timers are queued for SYS_TimerTaskHandler().
+	while (elapsed--) {
+		SYS_Timer_t *timer;
+		uint32_t expired = sysTimerExpired;
+
+		SysTimerTime += HW_TIMER_INTERVAL;
+
+		while ((timer = popExpiredTimer(SysTimerTime)) != NULL) {
+#ifdef SYS_TIMER_PROFILE
+			uint16_t start = hw_timer_get_count();
+#endif
+
+			if (timer->handler) {
+				timer->handler(timer);
+			}
+
+#ifdef SYS_TIMER_PROFILE
+			profileRecord(timer, wake, start);
+#endif
+		}
+
+		if (expired != sysTimerExpired) {
+			deadlines++;
+		}
+	}
+
+	// Each extra deadline served by this wakeup would have been a wakeup of its own
+	if (deadlines > 1) {
+		sysTimerStats.coalesced += deadlines - 1;
+	}
+}
+
+#ifdef HW_TIMER_TICKLESS
+/*****************************************************************************
+*****************************************************************************/
+static inline bool heapBefore(SYS_Timer_t *a, SYS_Timer_t *b)
+{
+	return (int32_t)(sysTimerWake(a) - sysTimerWake(b)) < 0;
+}
+
+/*****************************************************************************
+*****************************************************************************/
+static void heapSet(uint8_t pos, SYS_Timer_t *timer)
+{
+	heap[pos] = timer;
+	timer->heapPos = pos + 1;
+}
+
+/*****************************************************************************
+*****************************************************************************/
+static void heapSiftUp(uint8_t pos)
+{
+	SYS_Timer_t *timer = heap[pos];
+
+	while (pos && heapBefore(timer, heap[(pos - 1) / 2])) {
+		heapSet(pos, heap[(pos - 1) / 2]);
+		pos = (pos - 1) / 2;
+	}
+	heapSet(pos, timer);
+}
+
+/*****************************************************************************
+*****************************************************************************/
+static void heapSiftDown(uint8_t pos)
+{
+	SYS_Timer_t *timer = heap[pos];
+
+	while (2 * pos + 1 < heapCount) {
+		uint8_t child = 2 * pos + 1;
+
+		if ((child + 1 < heapCount) && heapBefore(heap[child + 1], heap[child])) {
+			child++;
+		}
+		if (!heapBefore(heap[child], timer)) {
+			break;
+		}
+		heapSet(pos, heap[child]);
+		pos = child;
+	}
+	heapSet(pos, timer);
+}
+
+/*****************************************************************************
+*****************************************************************************/
+static void heapInsert(SYS_Timer_t *timer)
+{
+	if (heapCount >= SYS_TIMER_HEAP_SIZE) {
+		timer->heapPos = SYS_TIMER_HEAP_MISSING;
+		heapMissing++;
+		return;
+	}
+
+	heap[heapCount] = timer;
+	heapSiftUp(heapCount++);
+}
+
+/*****************************************************************************
+*****************************************************************************/
+static void heapRemove(SYS_Timer_t *timer)
+{
+	uint8_t pos = timer->heapPos;
+
+	timer->heapPos = 0;
+
+	if (SYS_TIMER_HEAP_MISSING == pos) {
+		heapMissing--;
+		return;
+	}
+	if (0 == pos--) {
+		return;     // On the pending list
+	}
+
+	if (pos != --heapCount) {
+		// The last timer fills the hole and moves whichever way it has to
+		SYS_Timer_t *moved = heap[heapCount];
+
+		heapSet(pos, moved);
+		heapSiftUp(pos);
+		heapSiftDown(moved->heapPos - 1);
+	}
+}
+
+/*****************************************************************************
+*****************************************************************************/
+uint32_t SYS_TimerNextExpiry(void)
 {
-	SysTimerIrqCount++;
+	uint32_t next;
+
+	// Called from the hw timer interrupt, with interrupts disabled
+	if (heapMissing) {
+		// Can't tell the next deadline, wake every tick until the heap has room
+		return HW_TIMER_INTERVAL;
+	}
+	if (0 == heapCount) {
+		return UINT32_MAX;
+	}
+
+	next = sysTimerWake(heap[0]) - SysTimerTime;
+	return ((int32_t)next > 0) ? next : HW_TIMER_INTERVAL;
 }
+#endif
 
+/*****************************************************************************
+*****************************************************************************/
 uint32_t SYS_Timer_Time(void)
 {
-	return SysTimerTime;
+	return sysTimerNow();
+}
+
+/*! \brief  64 bit monotonic time in microseconds from the hw timer counter.
+ *          Does not wrap, safe to call from interrupt.
+ */
+uint64_t SYS_Timer_TimeUs(void)
+{
+	return hw_timer_get_time_us();
+}
+
+/*****************************************************************************
+*****************************************************************************/
+void SYS_TimerGetStats(SYS_TimerStats_t *stats)
+{
+	cpu_irq_enter_critical();
+	*stats = sysTimerStats;
+	cpu_irq_leave_critical();
+}
+
+#ifdef SYS_TIMER_PROFILE
+/*****************************************************************************
+*****************************************************************************/
+static void profileRecord(SYS_Timer_t *timer, uint32_t now, uint16_t start)
+{
+	uint16_t run = hw_timer_get_count() - start;
+	uint32_t late = ((int32_t)(now - timer->prof.deadline) > 0) ? (now - timer->prof.deadline) : 0;
+	uint8_t bucket = 0;
+
+	while (late && (bucket < SYS_TIMER_PROFILE_BUCKETS - 1)) {
+		late >>= 1;
+		bucket++;
+	}
+
+	cpu_irq_enter_critical();
+
+	if (!timer->prof.listed) {
+		timer->prof.listed = true;
+		timer->prof.next = profiled;
+		profiled = timer;
+	}
+
+	timer->prof.fired++;
+	if (timer->prof.late[bucket] < UINT16_MAX) {
+		timer->prof.late[bucket]++;
+	}
+	if (run > timer->prof.maxRun) {
+		timer->prof.maxRun = run;
+	}
+	timer->prof.totalRun += run;
+
+	cpu_irq_leave_critical();
+}
+
+/*! \brief  first timer that has fired since init, follow prof.next for the rest
+ */
+SYS_Timer_t *SYS_TimerProfileFirst(void)
+{
+	return profiled;
+}
+
+/*! \brief  clear the recorded profile of every timer that has fired
+ */
+void SYS_TimerProfileReset(void)
+{
+	cpu_irq_enter_critical();
+
+	for (SYS_Timer_t *t = profiled; t; t = t->prof.next) {
+		t->prof.fired = 0;
+		t->prof.maxRun = 0;
+		t->prof.totalRun = 0;
+		for (uint8_t i = 0; i < SYS_TIMER_PROFILE_BUCKETS; i++) {
+			t->prof.late[i] = 0;
+		}
+	}
+
+	cpu_irq_leave_critical();
+}
+#endif
+
+#ifdef INCLUDE_ALL_DEBUG_FUNCTIONS
+/*****************************************************************************
+*****************************************************************************/
+static bool sysTimerListed(SYS_Timer_t *timer)
+{
+	bool listed = false;
+
+	cpu_irq_enter_critical();
+
+	for (SYS_Timer_t *t = wheel[timer->expires & SYS_TIMER_WHEEL_MASK]; t; t = t->next) {
+		if (t == timer) {
+			listed = true;
+			break;
+		}
+	}
+	for (SYS_Timer_t *t = pendingHead; t && !listed; t = t->next) {
+		if (t == timer) {
+			listed = true;
+		}
+	}
+
+	cpu_irq_leave_critical();
+
+	return listed;
+}
+
+/*! \brief  verify every timer in the wheel and pending list is linked back
+ *          correctly, every wheel timer sits in the slot its deadline
+ *          hashes to, every slot is sorted by deadline and the tickless
+ *          deadline heap is ordered
+ */
+bool SYS_TimerCheck(void)
+{
+	bool ok = true;
+	SYS_Timer_t **link;
+
+	cpu_irq_enter_critical();
+
+	for (uint16_t i = 0; ok && (i < SYS_TIMER_WHEEL_SLOTS); i++) {
+		for (link = &wheel[i]; *link; link = &(*link)->next) {
+			if (((*link)->pprev != link) || (((*link)->expires & SYS_TIMER_WHEEL_MASK) != i) ||
+					((*link)->next && ((int32_t)((*link)->next->expires - (*link)->expires) < 0))) {
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	for (link = &pendingHead; ok && *link; link = &(*link)->next) {
+		if ((*link)->pprev != link) {
+			ok = false;
+		}
+	}
+	if (ok && (link != pendingTail)) {
+		ok = false;
+	}
+
+#ifdef HW_TIMER_TICKLESS
+	// Every heap entry knows its position and no child wakes before its parent
+	for (uint8_t i = 0; ok && (i < heapCount); i++) {
+		if ((heap[i]->heapPos != i + 1) || (i && heapBefore(heap[i], heap[(i - 1) / 2]))) {
+			ok = false;
+		}
+	}
+#endif
+
+	cpu_irq_leave_critical();
+
+	return ok;
 }
+#endif
@@ -54,6 +54,18 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include "compiler.h"
+#include "config.h"
+#include "conf_timer.h"
+
+/*- Definitions ------------------------------------------------------------*/
+// Build time initializer for timers whose parameters never change, so the
+// parameters come from flash with the rest of .data and need no init code:
+//   static SYS_Timer_t t = SYS_TIMER_INIT(250, SYS_TIMER_INTERVAL_MODE, tHandler);
+#define SYS_TIMER_INIT(_interval, _mode, _handler) \
+	{ .interval = (_interval), .mode = (_mode), .handler = (_handler) }
+
+#define SYS_TIMER_INIT_SLACK(_interval, _slack, _mode, _handler) \
+	{ .interval = (_interval), .slack = (_slack), .mode = (_mode), .handler = (_handler) }
 
 /*- Types ------------------------------------------------------------------*/
 typedef enum SYS_TimerMode_t {
@@ -61,17 +73,57 @@ typedef enum SYS_TimerMode_t {
 	SYS_TIMER_PERIODIC_MODE,
 } SYS_TimerMode_t;
 
+// Where the timer handler is called from
+typedef enum SYS_TimerDomain_t {
+	SYS_TIMER_DOMAIN_TASK,          // SYS_TimerTaskHandler() in the main loop
+	SYS_TIMER_DOMAIN_ISR,           // hw timer interrupt, runs in all sleep modes
+	SYS_TIMER_DOMAIN_COUNT,
+} SYS_TimerDomain_t;
+
+#ifdef SYS_TIMER_PROFILE
+// Lateness buckets are 0, 1, 2-3, 4-7 ... ms, the last one takes everything above
+typedef struct SYS_TimerProfile_t {
+	struct SYS_Timer_t *next;       // Next timer that has fired since init
+	bool listed;
+	uint32_t deadline;              // Deadline of the expiry being handled
+	uint32_t fired;
+	uint16_t late[SYS_TIMER_PROFILE_BUCKETS];
+	uint16_t maxRun;                // Longest handler run, hw timer counts
+	uint32_t totalRun;              // All handler runs, hw timer counts
+} SYS_TimerProfile_t;
+#endif
+
 typedef struct SYS_Timer_t {
 	/* Internal data */
-	struct SYS_Timer_t *next;
-	uint32_t timeout;
+	struct SYS_Timer_t *next;       // Next timer in the same wheel slot or pending list
+	struct SYS_Timer_t **pprev;     // Link pointing at this timer, NULL when stopped
+	uint32_t expires;               // Absolute SYS_Timer_Time() deadline
+#ifdef HW_TIMER_TICKLESS
+	uint8_t heapPos;                // Deadline heap position + 1, 0 when not in the heap
+#endif
 
 	/* Timer parameters */
 	uint32_t interval;
+	uint32_t slack;                 // ms the handler may run late so wakeups can be shared
 	SYS_TimerMode_t mode;
+	SYS_TimerDomain_t domain;
 	void (*handler)(struct SYS_Timer_t *timer);
+
+#ifdef SYS_TIMER_PROFILE
+	SYS_TimerProfile_t prof;
+#endif
 } SYS_Timer_t;
 
+typedef struct SYS_TimerStats_t {
+	uint32_t fired[SYS_TIMER_DOMAIN_COUNT];         // Handlers called
+	uint16_t active[SYS_TIMER_DOMAIN_COUNT];        // Timers currently started
+	uint32_t maxLatency;                            // Worst ms from deadline to task handler call
+	uint32_t maxStall;                              // Worst ms between SYS_TimerTaskHandler() calls
+	uint32_t late;                                  // Task handlers called more than a tick late
+	uint32_t coalesced;                             // Wakeups saved by serving several deadlines at once
+	uint32_t skipped;                               // Periodic deadlines missed and skipped
+} SYS_TimerStats_t;
+
 /*- Prototypes -------------------------------------------------------------*/
 void SYS_TimerInit(void);
 void SYS_TimerStart(SYS_Timer_t *timer);
@@ -80,8 +132,20 @@ void SYS_TimerStop(SYS_Timer_t *timer);
 bool SYS_TimerStarted(SYS_Timer_t *timer);
 uint32_t SYS_TimerTimeout(SYS_Timer_t *timer);
 void SYS_TimerTaskHandler(void);
-void SYS_HwExpiry_Cb(void);
+void SYS_HwExpiry_Cb(uint32_t elapsed);
+#ifdef HW_TIMER_TICKLESS
+uint32_t SYS_TimerNextExpiry(void);
+#endif
 uint32_t SYS_Timer_Time(void);
+uint64_t SYS_Timer_TimeUs(void);
+void SYS_TimerGetStats(SYS_TimerStats_t *stats);
+#ifdef INCLUDE_ALL_DEBUG_FUNCTIONS
+bool SYS_TimerCheck(void);
+#endif
+#ifdef SYS_TIMER_PROFILE
+SYS_Timer_t *SYS_TimerProfileFirst(void);
+void SYS_TimerProfileReset(void);
+#endif
 
 /** @} */
 #endif /* _SYS_TIMER_H_ */
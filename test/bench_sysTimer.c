@@ -0,0 +1,154 @@
+/*
+ * bench_sysTimer.c
+ *
+ * Host timing of the SYS timer engines at 16, 64 and 256 active timers. Built
+ * twice, against the timer wheel in src/timer and against delta/, a copy of
+ * the delta list the wheel replaced. Both runs use the same timers and the
+ * same operation order, so their ns/op columns compare directly. Host times
+ * only rank the engines, the SAMD21 numbers will differ.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sysTimer.h"
+
+#ifdef BENCH_DELTA_LIST
+    #define BENCH_ENGINE    "delta"
+    #define BENCH_TICK()    SYS_HwExpiry_Cb()
+#else
+    #define BENCH_ENGINE    "wheel"
+    #define BENCH_TICK()    SYS_HwExpiry_Cb(1)
+#endif
+
+#define BENCH_TIMERS_MAX    256
+#define BENCH_ROUNDS        200
+#define BENCH_TICKS         20000
+
+static SYS_Timer_t timers[BENCH_TIMERS_MAX];
+static uint16_t order[BENCH_TIMERS_MAX];
+static uint32_t seed;
+static volatile uint32_t handled;
+
+static uint32_t benchRandom(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void benchHandler(SYS_Timer_t *timer)
+{
+    handled++;
+}
+
+// count timers, intervals spread over 1..1000 ms like the firmware's, a scrambled order
+static void benchSetup(uint16_t count, SYS_TimerMode_t mode)
+{
+    SYS_TimerInit();
+    seed = 12345;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        memset(&timers[i], 0, sizeof(timers[i]));
+        timers[i].interval = 1 + (benchRandom() % 1000);
+        timers[i].mode     = mode;
+        timers[i].handler  = benchHandler;
+        order[i]           = i;
+    }
+    for (uint16_t i = count - 1; i > 0; i--)
+    {
+        uint16_t j = benchRandom() % (i + 1);
+        uint16_t t = order[i];
+
+        order[i] = order[j];
+        order[j] = t;
+    }
+}
+
+static void benchStopAll(uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        SYS_TimerStop(&timers[order[i]]);
+    }
+}
+
+static void benchRun(uint16_t count)
+{
+    uint64_t startNs = 0;
+    uint64_t stopNs = 0;
+    uint64_t restartNs;
+    uint64_t tickNs;
+    uint64_t t0;
+
+    // Start and stop every timer, in the scrambled order
+    benchSetup(count, SYS_TIMER_INTERVAL_MODE);
+    for (uint16_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        t0 = nowNs();
+        for (uint16_t i = 0; i < count; i++)
+        {
+            SYS_TimerStart(&timers[order[i]]);
+        }
+        startNs += nowNs() - t0;
+
+        t0 = nowNs();
+        benchStopAll(count);
+        stopNs += nowNs() - t0;
+    }
+
+    // Restart random timers with all of them running
+    for (uint16_t i = 0; i < count; i++)
+    {
+        SYS_TimerStart(&timers[i]);
+    }
+    t0 = nowNs();
+    for (uint32_t i = 0; i < (uint32_t)BENCH_ROUNDS * count; i++)
+    {
+        SYS_TimerRestart(&timers[benchRandom() % count]);
+    }
+    restartNs = nowNs() - t0;
+    benchStopAll(count);
+
+    // Ticks of the hw timer and the main loop, with every timer periodic
+    benchSetup(count, SYS_TIMER_PERIODIC_MODE);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        SYS_TimerStart(&timers[order[i]]);
+    }
+    handled = 0;
+    t0 = nowNs();
+    for (uint32_t i = 0; i < BENCH_TICKS; i++)
+    {
+        BENCH_TICK();
+        SYS_TimerTaskHandler();
+    }
+    tickNs = nowNs() - t0;
+    benchStopAll(count);
+
+    printf("%-6s %6u %10.1f %10.1f %10.1f %10.1f %10lu\n", BENCH_ENGINE, count,
+           (double)startNs / ((uint64_t)BENCH_ROUNDS * count), (double)stopNs / ((uint64_t)BENCH_ROUNDS * count),
+           (double)restartNs / ((uint64_t)BENCH_ROUNDS * count), (double)tickNs / BENCH_TICKS, (unsigned long)handled);
+}
+
+int main(void)
+{
+    static const uint16_t counts[] = {16, 64, 256};
+
+    printf("%-6s %6s %10s %10s %10s %10s %10s\n", "engine", "timers", "start ns", "stop ns", "restart ns",
+           "tick ns", "expiries");
+    for (uint8_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        benchRun(counts[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * stub_app.c
+ *
+ * Host stand-ins for the application modules around app_gen_io and app_arm.
+ * The BBU sleep-on-exit bit and the siren are flags the tests look at, and the
+ * timer handlers of the modules not under test do nothing. app_arm itself is
+ * stubbed in stub_arm.c.
+ */
+
+#include <asf.h>
+#include <string.h>
+#include "app_LED.h"
+#include "app_arm.h"
+#include "app_bbu.h"
+#include "app_buzzer.h"
+#include "app_daisychain.h"
+#include "app_eeprom.h"
+#include "app_timers.h"
+#include "app_uart.h"
+#include "stub_app.h"
+
+bool stubOnBattery;
+bool stubSleepOnExit;
+bool stubSiren;
+uint8_t stubAlarmEvents[STUB_ALARM_EVENTS_MAX];
+uint8_t stubAlarmEventCount;
+bool stubEepromReady;
+uint8_t stubDebounceConfig[EEPROM_BYTES_DEBOUNCE_CONFIG];
+
+void stubAppInit(void)
+{
+    stubOnBattery   = false;
+    stubSleepOnExit = false;
+    stubSiren       = false;
+    memset(stubAlarmEvents, 0, sizeof(stubAlarmEvents));
+    stubAlarmEventCount = 0;
+    stubEepromReady     = true;
+    memset(stubDebounceConfig, 0xFF, sizeof(stubDebounceConfig));
+}
+
+// ----------------------------------------------------------------------------
+//      app_bbu
+
+void app_bbu_request_active(void)
+{
+}
+
+// Only acts while the BBU sleeps, like the SCB->SCR write it stands in for
+void app_bbu_sleep_on_exit(bool sleepOnExit)
+{
+    if (stubOnBattery)
+    {
+        stubSleepOnExit = sleepOnExit;
+    }
+}
+
+// ----------------------------------------------------------------------------
+//      app_buzzer, app_daisychain, app_eeprom, app_LED, app_uart
+
+void app_buzzer_alarm_start(void)
+{
+    stubSiren = true;
+}
+
+void app_buzzer_alarm_stop(void)
+{
+    stubSiren = false;
+}
+
+void app_buzzer_stop_pattern(enum app_buzzer_pattern_t pattern)
+{
+}
+
+void app_daisychain_init(void)
+{
+}
+
+uint8_t app_eeprom_read_connect_wanted(void)
+{
+    return APP_EEPROM_MODEL_TYPE_CONNECTED;
+}
+
+// Blank until written, the emulator's status when it was never initialized otherwise
+enum status_code app_eeprom_read_debounceConfig(uint8_t *debounceConfig)
+{
+    if (!stubEepromReady)
+    {
+        return STATUS_ERR_NOT_INITIALIZED;
+    }
+    memcpy(debounceConfig, stubDebounceConfig, EEPROM_BYTES_DEBOUNCE_CONFIG);
+    return STATUS_OK;
+}
+
+enum status_code app_eeprom_write_debounceConfig(const uint8_t *debounceConfig)
+{
+    if (!stubEepromReady)
+    {
+        return STATUS_ERR_NOT_INITIALIZED;
+    }
+    memcpy(stubDebounceConfig, debounceConfig, EEPROM_BYTES_DEBOUNCE_CONFIG);
+    return STATUS_OK;
+}
+
+void app_led_update(void)
+{
+}
+
+bool UART_TX(const char *transmitString, ...)
+{
+    return true;
+}
+
+void UART_DBG_TX(const char *transmitString, ...)
+{
+}
+
+// ----------------------------------------------------------------------------
+//      Registered timer handlers of the other modules
+
+void adcCheckTimerHandler(SLP_Timer_t *timer)
+{
+}
+
+void appBatteryCheckTimerHandler(SYS_Timer_t *timer)
+{
+}
+
+void appBBUTimeLimitTimerHandler(SLP_Timer_t *timer)
+{
+}
+
+void updateTimeoutTimerHandler(SYS_Timer_t *timer)
+{
+}
+
+void updateRebootTimerHandler(SYS_Timer_t *timer)
+{
+}
+
+void dmaTimerHandler(SYS_Timer_t *timer)
+{
+}
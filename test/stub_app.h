@@ -0,0 +1,23 @@
+/*
+ * stub_app.h
+ */
+
+#ifndef STUB_APP_H_
+#define STUB_APP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define STUB_ALARM_EVENTS_MAX   16
+
+extern bool stubOnBattery;          // BBU asleep, app_bbu_sleep_on_exit() takes effect
+extern bool stubSleepOnExit;        // SLEEPONEXIT, the main loop doesn't run
+extern bool stubSiren;              // app_buzzer_alarm_start() more recent than _stop()
+extern uint8_t stubAlarmEvents[STUB_ALARM_EVENTS_MAX];
+extern uint8_t stubAlarmEventCount;
+extern bool stubEepromReady;        // false, the EEPROM emulator isn't initialized
+extern uint8_t stubDebounceConfig[];
+
+void stubAppInit(void);
+
+#endif /* STUB_APP_H_ */
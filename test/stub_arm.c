@@ -0,0 +1,87 @@
+/*
+ * stub_arm.c
+ *
+ * Host stand-in for app_arm, for the tests of the modules around it. Alarm
+ * events are recorded in stubAlarmEvents, everything else does nothing.
+ */
+
+#include <asf.h>
+#include "app_arm.h"
+#include "app_timers.h"
+#include "stub_app.h"
+
+// ----------------------------------------------------------------------------
+//      app_arm
+
+// Recorded in stubAlarmEvents
+void app_arm_alarmEvent(uint8_t alarmCause)
+{
+    if (stubAlarmEventCount < STUB_ALARM_EVENTS_MAX)
+    {
+        stubAlarmEvents[stubAlarmEventCount++] = alarmCause;
+    }
+}
+
+void app_arm_channel_closed(uint8_t channel)
+{
+}
+
+void app_arm_clear_PowerTamper_alarm(void)
+{
+}
+
+void app_arm_disarm(uint16_t duration)
+{
+}
+
+uint16_t app_arm_get_alarm_status(void)
+{
+    return 0;
+}
+
+uint32_t app_arm_get_not_ready(void)
+{
+    return 0;
+}
+
+bool app_arm_get_system_armed(void)
+{
+    return false;
+}
+
+bool app_arm_only_powerTamper_alarming(void)
+{
+    return false;
+}
+
+uint8_t app_arm_request(bool disarmOnFailure, uint8_t armIgnore)
+{
+    return 0;
+}
+
+void app_arm_reset_auto_arm_timer(void)
+{
+}
+
+void app_arm_set_PowerTamper_armed(bool powerTamperArmedState)
+{
+}
+
+void app_arm_set_not_ready(uint8_t reasons, bool notReady)
+{
+}
+
+// ----------------------------------------------------------------------------
+//      Registered timer handlers of app_arm
+
+void alarmEventTimerHandler(SYS_Timer_t *timer)
+{
+}
+
+void appDisarmFlashTimerHandler(SYS_Timer_t *timer)
+{
+}
+
+void tamperLimitTimerHandler(SYS_Timer_t *timer)
+{
+}
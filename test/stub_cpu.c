@@ -0,0 +1,20 @@
+/*
+ * stub_cpu.c
+ *
+ * Host stand-ins for the ASF interrupt control. There is one thread, so a
+ * critical section only has to nest correctly.
+ */
+
+#include <asf.h>
+
+static int criticalDepth;
+
+void cpu_irq_enter_critical(void)
+{
+    criticalDepth++;
+}
+
+void cpu_irq_leave_critical(void)
+{
+    criticalDepth--;
+}
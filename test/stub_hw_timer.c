@@ -0,0 +1,52 @@
+/*
+ * stub_hw_timer.c
+ *
+ * Host hw timer for the SYS timer core. Time only moves when the test calls
+ * SYS_HwExpiry_Cb(), so nothing is ever pending in the counter.
+ */
+
+#include "hw_timer.h"
+#include "stub_hw_timer.h"
+
+uint32_t stubHwRequestMs = UINT32_MAX;     // Earliest hw_timer_request() since the last clear
+uint32_t stubHwRequests;
+
+void hw_timer_init(void)
+{
+    stubHwRequestMs = UINT32_MAX;
+    stubHwRequests  = 0;
+}
+
+uint32_t hw_timer_elapsed(void)
+{
+    return 0;
+}
+
+uint16_t hw_timer_get_count(void)
+{
+    return 0;
+}
+
+uint64_t hw_timer_get_time_us(void)
+{
+    return 0;
+}
+
+uint32_t hw_timer_get_wakeups(void)
+{
+    return 0;
+}
+
+uint32_t hw_timer_get_isr_time_us(void)
+{
+    return 0;
+}
+
+void hw_timer_request(uint32_t ms)
+{
+    stubHwRequests++;
+    if (ms < stubHwRequestMs)
+    {
+        stubHwRequestMs = ms;
+    }
+}
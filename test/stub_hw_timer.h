@@ -0,0 +1,13 @@
+/*
+ * stub_hw_timer.h
+ */
+
+#ifndef STUB_HW_TIMER_H_
+#define STUB_HW_TIMER_H_
+
+#include <stdint.h>
+
+extern uint32_t stubHwRequestMs;
+extern uint32_t stubHwRequests;
+
+#endif /* STUB_HW_TIMER_H_ */
@@ -0,0 +1,150 @@
+/*
+ * stub_periph.c
+ *
+ * Host stand-ins for the PORT and EIC peripherals. The inline ASF accessors
+ * go straight to the register blocks, so host memory is mapped at their
+ * SAMD21 addresses and the pin levels are set in PORT IN. The EXTINT driver
+ * functions are replaced, an EIC line "fires" only while its callback is
+ * enabled, the way a masked line stays quiet on target.
+ */
+
+#include <asf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "stub_periph.h"
+
+#define PAGE_SIZE   0x1000ul
+
+static extint_callback_t extintCallbacks[EIC_NUMBER_OF_INTERRUPTS];
+static uint32_t extintEnabled;
+static uint32_t extintFiltered;
+static uint8_t extintCurrent;
+
+static void mapRegisters(uintptr_t base)
+{
+    static uintptr_t mapped[4];
+    uintptr_t page = base & ~(PAGE_SIZE - 1);
+    void *p;
+
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        if (mapped[i] == page)
+        {
+            memset((void *)page, 0, PAGE_SIZE);
+            return;
+        }
+        if (0 == mapped[i])
+        {
+            p = mmap((void *)page, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+                     -1, 0);
+            if (p != (void *)page)
+            {
+                printf("Can't map the peripheral page at %08lX\n", (unsigned long)page);
+                exit(2);
+            }
+            mapped[i] = page;
+            return;
+        }
+    }
+}
+
+// Zeroed registers, no callbacks registered or enabled
+void stubPeriphInit(void)
+{
+    mapRegisters((uintptr_t)PORT);
+    mapRegisters((uintptr_t)EIC);
+
+    memset(extintCallbacks, 0, sizeof(extintCallbacks));
+    extintEnabled = 0;
+    extintFiltered = 0;
+    extintCurrent = 0;
+}
+
+void stubPinSet(uint32_t pin, bool high)
+{
+    // IN is read-only to the firmware
+    volatile uint32_t *in = (volatile uint32_t *)&PORT->Group[pin / 32].IN.reg;
+
+    if (high)
+    {
+        *in |= (1ul << (pin % 32));
+    }
+    else
+    {
+        *in &= ~(1ul << (pin % 32));
+    }
+}
+
+bool stubExtintEnabled(uint8_t line)
+{
+    return (extintEnabled & (1ul << line)) != 0;
+}
+
+// FILTEN as last configured
+bool stubExtintFiltered(uint8_t line)
+{
+    return (extintFiltered & (1ul << line)) != 0;
+}
+
+// Calls the line's callback as the EIC interrupt would, false if the line is masked
+bool stubExtintFire(uint8_t line)
+{
+    if (!stubExtintEnabled(line) || !extintCallbacks[line])
+    {
+        return false;
+    }
+
+    extintCurrent = line;
+    extintCallbacks[line]();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+//      EXTINT driver
+
+void extint_chan_get_config_defaults(struct extint_chan_conf *const config)
+{
+    memset(config, 0, sizeof(*config));
+}
+
+void extint_chan_set_config(const uint8_t channel, const struct extint_chan_conf *const config)
+{
+    if (config->filter_input_signal)
+    {
+        extintFiltered |= (1ul << channel);
+    }
+    else
+    {
+        extintFiltered &= ~(1ul << channel);
+    }
+}
+
+enum status_code extint_register_callback(const extint_callback_t callback, const uint8_t channel,
+                                          const enum extint_callback_type type)
+{
+    extintCallbacks[channel] = callback;
+    return STATUS_OK;
+}
+
+enum status_code extint_chan_enable_callback(const uint8_t channel, const enum extint_callback_type type)
+{
+    extintEnabled |= (1ul << channel);
+    return STATUS_OK;
+}
+
+enum status_code extint_chan_disable_callback(const uint8_t channel, const enum extint_callback_type type)
+{
+    extintEnabled &= ~(1ul << channel);
+    return STATUS_OK;
+}
+
+uint8_t extint_get_current_channel(void)
+{
+    return extintCurrent;
+}
+
+void port_pin_set_config(const uint8_t gpio_pin, const struct port_config *const config)
+{
+}
@@ -0,0 +1,17 @@
+/*
+ * stub_periph.h
+ */
+
+#ifndef STUB_PERIPH_H_
+#define STUB_PERIPH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void stubPeriphInit(void);
+void stubPinSet(uint32_t pin, bool high);
+bool stubExtintEnabled(uint8_t line);
+bool stubExtintFiltered(uint8_t line);
+bool stubExtintFire(uint8_t line);
+
+#endif /* STUB_PERIPH_H_ */
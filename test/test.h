@@ -0,0 +1,48 @@
+/*
+ * test.h
+ *
+ * Minimal assertions for the host tests. A failed check is printed and counted,
+ * the test keeps going so one run shows every failure.
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+extern int testFailures;
+
+#define CHECK(expr)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(expr))                                                        \
+        {                                                                   \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr);\
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                      \
+    do                                                                      \
+    {                                                                       \
+        unsigned long long _a = (unsigned long long)(a);                    \
+        unsigned long long _b = (unsigned long long)(b);                    \
+        if (_a != _b)                                                       \
+        {                                                                   \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed, %llu != %llu\n",        \
+                   __FILE__, __LINE__, #a, #b, _a, _b);                     \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (0)
+
+#define TEST_RUN(fn)                                                        \
+    do                                                                      \
+    {                                                                       \
+        int _before = testFailures;                                         \
+        fn();                                                               \
+        printf("%s %s\n", (_before == testFailures) ? "PASS" : "FAIL", #fn);\
+    } while (0)
+
+#define TEST_EXIT()     ((testFailures) ? 1 : 0)
+
+#endif /* TEST_H_ */
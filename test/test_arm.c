@@ -0,0 +1,300 @@
+/*
+ * test_arm.c
+ *
+ * Arm/alarm state machine on the host: app_arm with the real app_gen_io and SYS
+ * timers, simulated PORT/EIC registers and the modules around them stubbed. The
+ * source is included so the test can reach the zones and their timers.
+ */
+
+#include <asf.h>
+#include <string.h>
+#include "app_arm.c"
+#include "app_gen_io.h"
+#include "app_timers.h"
+#include "sysTimer.h"
+#include "stub_app.h"
+#include "stub_periph.h"
+#include "test.h"
+
+int testFailures;
+
+// ms of hw timer ticks, the main loop runs after each
+static void run(uint32_t ms)
+{
+    while (ms--)
+    {
+        SYS_HwExpiry_Cb(1);
+        SYS_TimerTaskHandler();
+    }
+}
+
+// Powered, not master, every cable present, nDISARM low so nothing auto-arms,
+// through the boot settle time
+static void setup(void)
+{
+    static SYS_Timer_t bootTimers[APP_TIMER_COUNT];
+    static ArmZone_t bootZones[ARM_ZONE_COUNT];
+    static SYS_Timer_t bootDuration;
+    static bool saved;
+
+    // Timers are linked into the wheel SYS_TimerInit() is about to clear, start
+    // every test from the unlinked ones the firmware boots with
+    if (!saved)
+    {
+        memcpy(bootTimers, appTimers, sizeof(bootTimers));
+        memcpy(bootZones, armZones, sizeof(bootZones));
+        bootDuration = appDisarmDurationTimer;
+        saved = true;
+    }
+    memcpy(appTimers, bootTimers, sizeof(appTimers));
+    memcpy(armZones, bootZones, sizeof(armZones));
+    appDisarmDurationTimer = bootDuration;
+
+    stubPeriphInit();
+    stubAppInit();
+    SYS_TimerInit();
+
+    stubPinSet(POWER_GOOD_PIN, true);
+    stubPinSet(nMASTER_PIN, true);
+    stubPinSet(nDISARM_PIN, false);
+    for (uint8_t num = 0; num < CH_COUNT; num++)
+    {
+        stubPinSet(Channel[num].gpio_pin, false);
+    }
+
+    app_gen_io_init();
+    app_arm_init();
+    run(BOOT_SETTLE_MS + 1);
+
+    CHECK_EQ(app_gen_io_get_present_mask(), CH_ALL_MASK);
+}
+
+// Zone bitmaps agree with every zone's state, the siren with the alarming zones
+static void checkZones(void)
+{
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        uint8_t state = app_arm_get_state(z);
+
+        CHECK_EQ((zonesArmed >> z) & 1, ARM_STATE_DISARMED != state);
+        CHECK_EQ((zonesAlarming >> z) & 1, ARM_STATE_ALARMING == state);
+        CHECK_EQ((zonesSilent >> z) & 1, ARM_STATE_SILENT == state);
+    }
+    CHECK_EQ(stubSiren, zonesAlarming != 0);
+}
+
+// Dispatches one event and checks it against the table, the trace ring and the bitmaps
+static void checkDispatch(uint8_t zoneNum, uint8_t event, uint8_t cause)
+{
+    uint8_t from = app_arm_get_state(zoneNum);
+    const ArmTransition_t *transition = &armTransitions[from][event];
+    ArmTrace_t trace;
+
+    CHECK_EQ(armDispatch(zoneNum, event, cause), transition->next);
+    CHECK_EQ(app_arm_get_state(zoneNum), transition->next);
+
+    CHECK(app_arm_get_trace(0, &trace));
+    CHECK_EQ(trace.zone, zoneNum);
+    CHECK_EQ(trace.event, event);
+    CHECK_EQ(trace.cause, cause);
+    CHECK_EQ(trace.from, from);
+    CHECK_EQ(trace.to, transition->next);
+
+    // SILENT only goes back to DISARMED through a disarm, never by auto-arm
+    if ((ARM_STATE_SILENT == from) && (ARM_STATE_DISARMED == transition->next))
+    {
+        CHECK_EQ(transition->actions & ARM_ACTS_DISARM, ARM_ACTS_DISARM);
+    }
+    if ((ARM_STATE_SILENT == from) && (ARM_EVENT_AUTO_ARM == event))
+    {
+        CHECK_EQ(transition->next, ARM_STATE_SILENT);
+    }
+
+    checkZones();
+}
+
+// Drives a zone from DISARMED to state through the events that normally get it there
+static void zoneTo(uint8_t zoneNum, uint8_t state)
+{
+    armDispatch(zoneNum, ARM_EVENT_DISARM, ARM_TRACE_NO_CAUSE);
+    if (state >= ARM_STATE_ARMED)
+    {
+        armDispatch(zoneNum, ARM_EVENT_ARM, ARM_TRACE_NO_CAUSE);
+    }
+    if (state >= ARM_STATE_ALARMING)
+    {
+        armDispatch(zoneNum, ARM_EVENT_ALARM, CHANNEL_0_SWITCH_WAS_OPENED);
+    }
+    if (state >= ARM_STATE_SILENT)
+    {
+        armDispatch(zoneNum, ARM_EVENT_SILENCE, ARM_TRACE_NO_CAUSE);
+    }
+    CHECK_EQ(app_arm_get_state(zoneNum), state);
+}
+
+static uint32_t testRandom(void)
+{
+    static uint32_t seed = 12345;
+
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// ----------------------------------------------------------------------------
+
+// A tamper with no zone armed sounds the siren for the alarm limit, no zone leaves
+// DISARMED and the module doesn't report armed
+static void testTamperWithNoZoneArmed(void)
+{
+    setup();
+    app_arm_set_PowerTamper_armed(SYSTEM_ARMED);
+
+    app_arm_alarmEvent(POWER_TAMPER_nMASTER_ALARM);
+    run(1);
+
+    CHECK(stubSiren);
+    CHECK(app_arm_is_any_alarm_active());
+    CHECK(!app_arm_get_system_armed());
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        CHECK_EQ(app_arm_get_state(z), ARM_STATE_DISARMED);
+    }
+
+    run(ALARM_TIME_BEFORE_SILENT);
+
+    CHECK(!stubSiren);
+    CHECK(!app_arm_is_any_alarm_active());
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_DISARMED);
+}
+
+// An armed zone alarms, goes silent at the alarm limit and disarms
+static void testArmedZoneAlarmLimit(void)
+{
+    setup();
+    app_arm_set_PowerTamper_armed(SYSTEM_ARMED);
+    app_arm_arm();
+
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_ARMED);
+    CHECK(app_arm_get_system_armed());
+
+    app_arm_alarmEvent(POWER_TAMPER_nMASTER_ALARM);
+    run(1);
+
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_ALARMING);
+    CHECK(stubSiren);
+
+    run(ALARM_TIME_BEFORE_SILENT);
+
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_SILENT);
+    CHECK(!stubSiren);
+    CHECK(app_arm_get_system_armed());
+
+    app_arm_disarm(0);
+
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_DISARMED);
+    CHECK(!app_arm_get_system_armed());
+    CHECK(!app_arm_is_any_alarm_active());
+}
+
+// A repost of a pending cause is coalesced into it, a second cause for a zone in the same
+// pass is dropped
+static void testAlarmEventStats(void)
+{
+    uint32_t posted[2];
+    uint32_t coalesced[2];
+    uint32_t dropped[2];
+
+    setup();
+    app_arm_set_PowerTamper_armed(SYSTEM_ARMED);
+    app_arm_arm();
+    app_arm_get_alarm_event_stats(&posted[0], &coalesced[0], &dropped[0]);
+
+    app_arm_alarmEvent(CHANNEL_0_SWITCH_WAS_OPENED);
+    app_arm_alarmEvent(CHANNEL_0_SWITCH_WAS_OPENED);
+    app_arm_alarmEvent(POWER_TAMPER_nMASTER_ALARM);
+    run(1);
+    app_arm_get_alarm_event_stats(&posted[1], &coalesced[1], &dropped[1]);
+
+    CHECK_EQ(posted[1] - posted[0], 3);
+    CHECK_EQ(coalesced[1] - coalesced[0], 1);
+    CHECK_EQ(dropped[1] - dropped[0], 1);
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_ALARMING);
+}
+
+// Arming leaves a zone with no channels disarmed, so channels can still be moved to it
+static void testArmSkipsEmptyZone(void)
+{
+    setup();
+    app_arm_arm();
+
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_ARMED);
+    CHECK_EQ(app_arm_get_state(1), ARM_STATE_DISARMED);
+    CHECK(app_arm_assign_zone_channels(1, 0));
+    CHECK(!app_arm_assign_zone_channels(1, CH_MASK(0)));
+
+    app_arm_disarm_zone(0);
+
+    CHECK(app_arm_assign_zone_channels(1, CH_MASK(0)));
+    app_arm_arm();
+    CHECK_EQ(app_arm_get_state(0), ARM_STATE_ARMED);
+    CHECK_EQ(app_arm_get_state(1), ARM_STATE_ARMED);
+}
+
+// Every (state, event) pair in every zone does what the table says
+static void testTransitionTable(void)
+{
+    setup();
+
+    for (uint8_t z = 0; z < ARM_ZONE_COUNT; z++)
+    {
+        for (uint8_t state = 0; state < ARM_STATE_COUNT; state++)
+        {
+            for (uint8_t event = 0; event < ARM_EVENT_COUNT; event++)
+            {
+                zoneTo(z, state);
+                checkDispatch(z, event, (ARM_EVENT_ALARM == event) ? CHANNEL_0_SWITCH_WAS_OPENED : ARM_TRACE_NO_CAUSE);
+            }
+        }
+    }
+}
+
+// Random events into random zones, with time passing so the zone timers fire too
+static void testTransitionFuzz(void)
+{
+    setup();
+
+    for (uint16_t step = 0; step < 5000; step++)
+    {
+        uint8_t zoneNum = testRandom() % ARM_ZONE_COUNT;
+        uint8_t event = testRandom() % ARM_EVENT_COUNT;
+        uint8_t cause = ARM_TRACE_NO_CAUSE;
+
+        if (ARM_EVENT_ALARM == event)
+        {
+            cause = CHANNEL_0_SWITCH_WAS_OPENED + (testRandom() % CH_COUNT);
+        }
+        checkDispatch(zoneNum, event, cause);
+
+        if (0 == (testRandom() % 50))
+        {
+            run(ALARM_TIME_BEFORE_SILENT);
+            checkZones();
+        }
+        if (testFailures)
+        {
+            break;
+        }
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(testTamperWithNoZoneArmed);
+    TEST_RUN(testArmedZoneAlarmLimit);
+    TEST_RUN(testAlarmEventStats);
+    TEST_RUN(testArmSkipsEmptyZone);
+    TEST_RUN(testTransitionTable);
+    TEST_RUN(testTransitionFuzz);
+
+    return TEST_EXIT();
+}
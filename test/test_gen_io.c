@@ -0,0 +1,266 @@
+/*
+ * test_gen_io.c
+ *
+ * Channel inputs on the host: app_gen_io with the real SYS timers, simulated
+ * PORT/EIC registers and the modules around it stubbed. Time is advanced one
+ * tick at a time; the main loop only runs while sleep-on-exit is clear, the
+ * way it does when the BBU sleeps.
+ */
+
+#include <asf.h>
+#include <string.h>
+#include "app_arm.h"
+#include "app_eeprom.h"
+#include "app_gen_io.h"
+#include "app_timers.h"
+#include "sysTimer.h"
+#include "stub_app.h"
+#include "stub_periph.h"
+#include "test.h"
+
+int testFailures;
+
+#define TEST_CHANNEL    0
+
+// One ms tick of the hw timer, then the main loop if it is awake. With nothing left
+// for it to do it goes back to sleeping on exit.
+static void run(uint32_t ms)
+{
+    SYS_TimerStats_t stats;
+
+    while (ms--)
+    {
+        SYS_HwExpiry_Cb(1);
+
+        if (!stubSleepOnExit)
+        {
+            SYS_TimerTaskHandler();
+
+            SYS_TimerGetStats(&stats);
+            if (0 == stats.active[SYS_TIMER_DOMAIN_TASK])
+            {
+                app_bbu_sleep_on_exit(true);
+            }
+        }
+    }
+}
+
+static bool alarmed(uint8_t cause)
+{
+    for (uint8_t i = 0; i < stubAlarmEventCount; i++)
+    {
+        if (stubAlarmEvents[i] == cause)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Powered, not master, every cable present, through the boot settle time
+static void setup(void)
+{
+    static SYS_Timer_t bootTimers[APP_TIMER_COUNT];
+    static bool saved;
+
+    // The registered timers are initialized at build time, start every test from there
+    if (!saved)
+    {
+        memcpy(bootTimers, appTimers, sizeof(bootTimers));
+        saved = true;
+    }
+    memcpy(appTimers, bootTimers, sizeof(appTimers));
+
+    stubPeriphInit();
+    stubAppInit();
+    SYS_TimerInit();
+
+    stubPinSet(POWER_GOOD_PIN, true);
+    stubPinSet(nMASTER_PIN, true);
+    for (uint8_t num = 0; num < CH_COUNT; num++)
+    {
+        stubPinSet(Channel[num].gpio_pin, false);
+    }
+
+    app_gen_io_init();
+    run(BOOT_SETTLE_MS + 1);
+
+    CHECK(app_gen_io_is_boot_ready());
+    CHECK_EQ(app_gen_io_get_present_mask(), CH_ALL_MASK);
+}
+
+// Edges on the channel faster than the chatter limit, 1 ms apart, ending closed
+static void chatter(uint8_t num)
+{
+    bool open = false;
+
+    for (uint8_t i = 0; i <= CHATTER_EDGE_LIMIT; i++)
+    {
+        open = !open;
+        stubPinSet(Channel[num].gpio_pin, open);
+        stubExtintFire(Channel[num].gpio_eic_line);
+        run(1);
+    }
+    stubPinSet(Channel[num].gpio_pin, false);
+    stubExtintFire(Channel[num].gpio_eic_line);
+}
+
+// ----------------------------------------------------------------------------
+
+// A chattering channel gets its EIC line masked and stays present
+static void testChatterQuarantine(void)
+{
+    setup();
+    app_gen_io_arm_ports(CH_MASK(TEST_CHANNEL));
+
+    chatter(TEST_CHANNEL);
+    run(CHATTER_POLL_INTERVAL_MS);
+
+    CHECK(!stubExtintEnabled(Channel[TEST_CHANNEL].gpio_eic_line));
+    CHECK_EQ(app_gen_io_get_fault_mask(), CH_MASK(TEST_CHANNEL));
+    CHECK(app_gen_io_get_present_mask() & CH_MASK(TEST_CHANNEL));
+    CHECK_EQ(stubAlarmEventCount, 0);
+}
+
+// An armed quarantined port lifted while the BBU sleeps on exit still alarms. The
+// line is masked, so only the chatter poll can see the lift and wake the main loop.
+static void testQuarantinedLiftOnBattery(void)
+{
+    const DebounceProfile_t *profile;
+
+    setup();
+    app_gen_io_arm_ports(CH_MASK(TEST_CHANNEL));
+    profile = app_gen_io_get_debounce_profile(app_gen_io_get_channel_profile(TEST_CHANNEL));
+
+    stubOnBattery = true;
+    chatter(TEST_CHANNEL);
+    run(CHATTER_POLL_INTERVAL_MS);
+
+    CHECK_EQ(app_gen_io_get_fault_mask(), CH_MASK(TEST_CHANNEL));
+    CHECK(stubSleepOnExit);
+
+    // Lifted without an edge interrupt, the poll has to find it
+    stubPinSet(Channel[TEST_CHANNEL].gpio_pin, true);
+    CHECK(!stubExtintFire(Channel[TEST_CHANNEL].gpio_eic_line));
+    run(CHATTER_POLL_INTERVAL_MS + (profile->liftTime + profile->qualifyTime) * DEBOUNCE_PROFILE_UNIT_MS + DEBOUNCE_TICK_MS);
+
+    CHECK(alarmed(CHANNEL_0_SWITCH_WAS_OPENED + TEST_CHANNEL));
+    CHECK(app_gen_io_is_port_alarming(TEST_CHANNEL));
+    CHECK(!(app_gen_io_get_present_mask() & CH_MASK(TEST_CHANNEL)));
+
+    // Back to sleep once the lift is reported
+    run(DEBOUNCE_TICK_MS);
+    CHECK(stubSleepOnExit);
+}
+
+// A quarantined channel that holds one level is handed back to its interrupt
+static void testQuarantineRelease(void)
+{
+    setup();
+
+    stubOnBattery = true;
+    chatter(TEST_CHANNEL);
+    run(CHATTER_POLL_INTERVAL_MS * (CHATTER_RELEASE_POLLS + 1));
+
+    CHECK_EQ(app_gen_io_get_fault_mask(), 0);
+    CHECK(stubExtintEnabled(Channel[TEST_CHANNEL].gpio_eic_line));
+    CHECK(app_gen_io_get_present_mask() & CH_MASK(TEST_CHANNEL));
+}
+
+// Edges and debounced transitions are counted against the filter setting they happened in
+static void testInputFilterStats(void)
+{
+    InputFilterStats_t off;
+    InputFilterStats_t on;
+    const DebounceProfile_t *profile;
+    
+    setup();
+    profile = app_gen_io_get_debounce_profile(app_gen_io_get_channel_profile(TEST_CHANNEL));
+    
+    CHECK(app_gen_io_get_input_filter());
+    CHECK(stubExtintFiltered(Channel[TEST_CHANNEL].gpio_eic_line));
+    
+    app_gen_io_set_input_filter(false);
+    CHECK(!stubExtintFiltered(Channel[TEST_CHANNEL].gpio_eic_line));
+    
+    // Lift with 2 bounces, 5 edges for one transition
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        stubPinSet(Channel[TEST_CHANNEL].gpio_pin, !(i & 1));
+        stubExtintFire(Channel[TEST_CHANNEL].gpio_eic_line);
+    }
+    run(profile->liftTime * DEBOUNCE_PROFILE_UNIT_MS + DEBOUNCE_TICK_MS);
+    
+    app_gen_io_set_input_filter(true);
+    CHECK(stubExtintFiltered(Channel[TEST_CHANNEL].gpio_eic_line));
+    
+    // Clean re-seat
+    stubPinSet(Channel[TEST_CHANNEL].gpio_pin, false);
+    stubExtintFire(Channel[TEST_CHANNEL].gpio_eic_line);
+    run(profile->pressTime * DEBOUNCE_PROFILE_UNIT_MS + DEBOUNCE_TICK_MS);
+    
+    app_gen_io_get_input_filter_stats(false, &off);
+    app_gen_io_get_input_filter_stats(true, &on);
+    
+    CHECK_EQ(off.edges, 5);
+    CHECK_EQ(off.transitions, 1);
+    CHECK_EQ(on.edges, 1);
+    CHECK_EQ(on.transitions, 1);
+    CHECK(off.timeMs >= profile->liftTime * DEBOUNCE_PROFILE_UNIT_MS);
+}
+
+// Only channel edges take ring slots, a busy nDISARM or power good line can't overflow it
+static void testEdgeRingChannelsOnly(void)
+{
+    setup();
+    
+    for (uint8_t i = 0; i <= EDGE_RING_SIZE; i++)
+    {
+        stubPinSet(nDISARM_PIN, i & 1);
+        CHECK(stubExtintFire(nDISARM_EIC_LINE));
+        stubPinSet(POWER_GOOD_PIN, !(i & 1));
+        CHECK(stubExtintFire(POWER_GOOD_EIC_LINE));
+    }
+    stubPinSet(POWER_GOOD_PIN, true);
+    run(STANDARD_DEBOUNCE_INTERVAL_MS);
+    
+    CHECK_EQ(app_gen_io_get_edge_overflows(), 0);
+    
+    // A lift still gets its edge time
+    stubPinSet(Channel[TEST_CHANNEL].gpio_pin, true);
+    stubExtintFire(Channel[TEST_CHANNEL].gpio_eic_line);
+    run(DEBOUNCE_TICK_MS);
+    CHECK_EQ(app_gen_io_get_channel_timing(TEST_CHANNEL)->bounceEdges, 1);
+}
+
+// Profiles go to the debounce config bytes, a failed save is reported and the profile
+// is still used until reset
+static void testProfileSave(void)
+{
+    const DebounceProfile_t slow = {50, 40, 30};
+    
+    setup();
+    
+    CHECK_EQ(app_gen_io_set_debounce_profile(1, &slow), STATUS_OK);
+    CHECK_EQ(app_gen_io_set_channel_profile(TEST_CHANNEL, 1), STATUS_OK);
+    CHECK_EQ(stubDebounceConfig[DEBOUNCE_CONFIG_INDEX_MAGIC], DEBOUNCE_CONFIG_MAGIC);
+    CHECK_EQ(stubDebounceConfig[DEBOUNCE_CONFIG_INDEX_PROFILES + 3], slow.liftTime);
+    CHECK_EQ((stubDebounceConfig[DEBOUNCE_CONFIG_INDEX_CHANNEL_PROFILES + TEST_CHANNEL / 2] >> ((TEST_CHANNEL % 2) * 4)) & 0x0F, 1);
+    CHECK_EQ(app_gen_io_set_debounce_profile(DEBOUNCE_PROFILE_COUNT, &slow), STATUS_ERR_INVALID_ARG);
+    
+    stubEepromReady = false;
+    CHECK_EQ(app_gen_io_set_channel_profile(TEST_CHANNEL, 2), STATUS_ERR_NOT_INITIALIZED);
+    CHECK_EQ(app_gen_io_get_channel_profile(TEST_CHANNEL), 2);
+}
+
+int main(void)
+{
+    TEST_RUN(testChatterQuarantine);
+    TEST_RUN(testQuarantinedLiftOnBattery);
+    TEST_RUN(testQuarantineRelease);
+    TEST_RUN(testInputFilterStats);
+    TEST_RUN(testEdgeRingChannelsOnly);
+    TEST_RUN(testProfileSave);
+
+    return TEST_EXIT();
+}
@@ -0,0 +1,125 @@
+/*
+ * test_hw_timer.c
+ *
+ * hw timer clock on the host. TC3 is simulated as a free running 16 bit
+ * counter at HW_TIMER_PERIOD counts per ms and the compare callback is called
+ * when the counter passes CC0, a little late as it would be on target. The
+ * source is included so the test can reach the static compare callback.
+ */
+
+#include "hw_timer.c"
+#include "test.h"
+
+int testFailures;
+
+#define COUNTS_PER_DAY  (24ull * 60 * 60 * 1000 * HW_TIMER_PERIOD)
+
+static uint64_t simCounts;          // Counts since init, never wraps
+static uint16_t simCompare;
+static uint64_t deliveredMs;        // Sum of the elapsed ms given to the SYS timers
+
+// ----------------------------------------------------------------------------
+//      TC3 and SYS timer stand-ins
+
+uint32_t tc_get_count_value(const struct tc_module *const module_inst)
+{
+    return (uint16_t)simCounts;
+}
+
+enum status_code tc_set_compare_value(const struct tc_module *const module_inst,
+                                      const enum tc_compare_capture_channel channel_index, const uint32_t compare_value)
+{
+    simCompare = compare_value;
+    return STATUS_OK;
+}
+
+enum status_code tc_init(struct tc_module *const module_inst, Tc *const hw, const struct tc_config *const config)
+{
+    return STATUS_OK;
+}
+
+enum status_code tc_register_callback(struct tc_module *const module, tc_callback_t callback_func,
+                                      const enum tc_callback callback_type)
+{
+    return STATUS_OK;
+}
+
+uint8_t _tc_get_inst_index(Tc *const hw)
+{
+    return 0;
+}
+
+void SYS_HwExpiry_Cb(uint32_t elapsed)
+{
+    deliveredMs += elapsed;
+}
+
+static uint32_t testRandom(void)
+{
+    static uint32_t seed = 12345;
+
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+#ifdef HW_TIMER_TICKLESS
+// Next SYS deadline anywhere from the next tick to past the longest the
+// compare may be programmed out
+uint32_t SYS_TimerNextExpiry(void)
+{
+    return 1 + (testRandom() % (HW_TIMER_TICKLESS_MAX_MS + 100));
+}
+#endif
+
+// ----------------------------------------------------------------------------
+
+// A day of counts, with reads between interrupts and interrupts served up to
+// 40 counts late. The us clock is the exact count conversion at every read,
+// and the ms delivered to the SYS timers never fall behind the counter.
+static void testDayWithoutDrift(void)
+{
+    uint64_t lastUs = 0;
+
+    // Power-on state of the statics, hw_timer_init() needs the real TC3
+    simCounts   = 0;
+    simCompare  = HW_TIMER_PERIOD;
+    deliveredMs = 0;
+    armedMs     = HW_TIMER_INTERVAL;
+
+    while (simCounts < COUNTS_PER_DAY)
+    {
+        uint32_t toMatch = (uint16_t)(simCompare - (uint16_t)simCounts);
+        uint32_t span    = toMatch + (testRandom() % 40);
+        uint32_t read;
+        uint64_t us;
+
+        // The match is always ahead and inside one counter wrap
+        CHECK(toMatch && (span < 0x10000));
+        if (testFailures)
+        {
+            break;  // One report, not one per remaining interrupt
+        }
+
+        read = testRandom() % span;
+        simCounts += read;
+        us = hw_timer_get_time_us();
+        CHECK_EQ(us, simCounts * 1000 / HW_TIMER_PERIOD);
+        CHECK(us >= lastUs);
+        lastUs = us;
+
+        simCounts += span - read;
+        hw_timer_callback(&module_inst);
+        CHECK_EQ(deliveredMs, simCounts / HW_TIMER_PERIOD);
+        CHECK_EQ(hw_timer_get_time_us(), simCounts * 1000 / HW_TIMER_PERIOD);
+    }
+
+    CHECK(simCounts >= COUNTS_PER_DAY);
+    CHECK_EQ(lastMs, deliveredMs);
+}
+
+int main(void)
+{
+    TEST_RUN(testDayWithoutDrift);
+
+    return TEST_EXIT();
+}
@@ -0,0 +1,502 @@
+/*
+ * test_sysTimer.c
+ *
+ * SYS timer wheel on the host. Time is advanced one tick at a time through
+ * SYS_HwExpiry_Cb(), the way the hw timer interrupt does it.
+ */
+
+#include <string.h>
+#include "sysTimer.h"
+#include "slpTimer.h"
+#include "stub_hw_timer.h"
+#include "test.h"
+
+int testFailures;
+
+#define FIRED_MAX   64
+
+typedef struct Fired_t
+{
+    SYS_Timer_t *timer;
+    uint32_t    timeMs;
+} Fired_t;
+
+static Fired_t fired[FIRED_MAX];
+static uint8_t firedCount;
+
+static void recordHandler(SYS_Timer_t *timer)
+{
+    if (firedCount < FIRED_MAX)
+    {
+        fired[firedCount].timer  = timer;
+        fired[firedCount].timeMs = SYS_Timer_Time();
+        firedCount++;
+    }
+}
+
+static void stopSelfHandler(SYS_Timer_t *timer)
+{
+    recordHandler(timer);
+    SYS_TimerStop(timer);
+}
+
+static uint32_t testRandom(void)
+{
+    static uint32_t seed = 12345;
+
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static void setup(void)
+{
+    SYS_TimerInit();
+    memset(fired, 0, sizeof(fired));
+    firedCount = 0;
+}
+
+// ms ticks of the hw timer, with the main loop running after each one
+static void run(uint32_t ms)
+{
+    while (ms--)
+    {
+        SYS_HwExpiry_Cb(1);
+        SYS_TimerTaskHandler();
+    }
+}
+
+static void timerInit(SYS_Timer_t *timer, uint32_t interval, SYS_TimerMode_t mode)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->interval = interval;
+    timer->mode     = mode;
+    timer->handler  = recordHandler;
+}
+
+// ----------------------------------------------------------------------------
+
+// Deadlines that hash to the same slot fire in deadline order, each on its own
+// revolution, and equal deadlines fire in the order they were started
+static void testSlotOrdering(void)
+{
+    SYS_Timer_t late;
+    SYS_Timer_t later;
+    SYS_Timer_t first;
+    SYS_Timer_t tieA;
+    SYS_Timer_t tieB;
+
+    setup();
+    timerInit(&later, 5 + 2 * SYS_TIMER_WHEEL_SLOTS, SYS_TIMER_INTERVAL_MODE);
+    timerInit(&late, 5 + SYS_TIMER_WHEEL_SLOTS, SYS_TIMER_INTERVAL_MODE);
+    timerInit(&tieA, 5, SYS_TIMER_INTERVAL_MODE);
+    timerInit(&first, 3, SYS_TIMER_INTERVAL_MODE);
+    timerInit(&tieB, 5, SYS_TIMER_INTERVAL_MODE);
+
+    SYS_TimerStart(&later);
+    SYS_TimerStart(&late);
+    SYS_TimerStart(&tieA);
+    SYS_TimerStart(&first);
+    SYS_TimerStart(&tieB);
+    CHECK(SYS_TimerCheck());
+
+    run(5 + 2 * SYS_TIMER_WHEEL_SLOTS);
+
+    CHECK_EQ(firedCount, 5);
+    CHECK(fired[0].timer == &first);
+    CHECK_EQ(fired[0].timeMs, 3);
+    CHECK(fired[1].timer == &tieA);
+    CHECK(fired[2].timer == &tieB);
+    CHECK_EQ(fired[1].timeMs, 5);
+    CHECK_EQ(fired[2].timeMs, 5);
+    CHECK(fired[3].timer == &late);
+    CHECK_EQ(fired[3].timeMs, 5 + SYS_TIMER_WHEEL_SLOTS);
+    CHECK(fired[4].timer == &later);
+    CHECK_EQ(fired[4].timeMs, 5 + 2 * SYS_TIMER_WHEEL_SLOTS);
+    CHECK(SYS_TimerCheck());
+}
+
+// Stopping a timer in the middle of a slot keeps the rest of it in order
+static void testStopInSlot(void)
+{
+    SYS_Timer_t a;
+    SYS_Timer_t b;
+    SYS_Timer_t c;
+
+    setup();
+    timerInit(&a, 7, SYS_TIMER_INTERVAL_MODE);
+    timerInit(&b, 7 + SYS_TIMER_WHEEL_SLOTS, SYS_TIMER_INTERVAL_MODE);
+    timerInit(&c, 7 + 2 * SYS_TIMER_WHEEL_SLOTS, SYS_TIMER_INTERVAL_MODE);
+    SYS_TimerStart(&c);
+    SYS_TimerStart(&a);
+    SYS_TimerStart(&b);
+
+    SYS_TimerStop(&b);
+    CHECK(!SYS_TimerStarted(&b));
+    CHECK(SYS_TimerCheck());
+
+    run(7 + 2 * SYS_TIMER_WHEEL_SLOTS);
+
+    CHECK_EQ(firedCount, 2);
+    CHECK(fired[0].timer == &a);
+    CHECK(fired[1].timer == &c);
+}
+
+// A periodic timer is re-placed from its deadline, so it keeps its cadence
+static void testPeriodicCadence(void)
+{
+    SYS_Timer_t periodic;
+
+    setup();
+    timerInit(&periodic, 10, SYS_TIMER_PERIODIC_MODE);
+    SYS_TimerStart(&periodic);
+
+    run(100);
+
+    CHECK_EQ(firedCount, 10);
+    for (uint8_t i = 0; i < firedCount; i++)
+    {
+        CHECK_EQ(fired[i].timeMs, 10 * (i + 1));
+    }
+    CHECK(SYS_TimerStarted(&periodic));
+    CHECK(SYS_TimerCheck());
+}
+
+// A main loop stall runs the overdue periodic timer once, skips the deadlines it
+// missed and keeps the phase of the original cadence
+static void testPeriodicStall(void)
+{
+    SYS_Timer_t periodic;
+    SYS_TimerStats_t stats;
+
+    setup();
+    timerInit(&periodic, 10, SYS_TIMER_PERIODIC_MODE);
+    SYS_TimerStart(&periodic);
+
+    // Interrupt keeps ticking, the main loop doesn't run for 35 ms
+    for (uint8_t i = 0; i < 35; i++)
+    {
+        SYS_HwExpiry_Cb(1);
+    }
+    SYS_TimerTaskHandler();
+
+    CHECK_EQ(firedCount, 1);
+    CHECK_EQ(fired[0].timeMs, 35);
+
+    run(20);
+
+    CHECK_EQ(firedCount, 3);
+    CHECK_EQ(fired[1].timeMs, 40);
+    CHECK_EQ(fired[2].timeMs, 50);
+
+    SYS_TimerGetStats(&stats);
+    CHECK_EQ(stats.skipped, 2);
+}
+
+// A periodic handler that stops itself is not re-placed
+static void testPeriodicStopInHandler(void)
+{
+    SYS_Timer_t periodic;
+
+    setup();
+    timerInit(&periodic, 10, SYS_TIMER_PERIODIC_MODE);
+    periodic.handler = stopSelfHandler;
+    SYS_TimerStart(&periodic);
+
+    run(50);
+
+    CHECK_EQ(firedCount, 1);
+    CHECK(!SYS_TimerStarted(&periodic));
+    CHECK(SYS_TimerCheck());
+}
+
+// Interrupt domain timers run from the hw timer tick alone, task timers wait for
+// the main loop
+static void testDomains(void)
+{
+    SYS_Timer_t task;
+    SLP_Timer_t isr;
+
+    setup();
+    timerInit(&task, 20, SYS_TIMER_INTERVAL_MODE);
+    timerInit(&isr, 20, SYS_TIMER_INTERVAL_MODE);
+    SYS_TimerStart(&task);
+    SLP_TimerStart(&isr);
+
+    for (uint8_t i = 0; i < 30; i++)
+    {
+        SYS_HwExpiry_Cb(1);
+    }
+
+    CHECK_EQ(firedCount, 1);
+    CHECK(fired[0].timer == &isr);
+    CHECK_EQ(fired[0].timeMs, 20);
+    CHECK(SYS_TimerStarted(&task));
+
+    SYS_TimerTaskHandler();
+
+    CHECK_EQ(firedCount, 2);
+    CHECK(fired[1].timer == &task);
+    CHECK(!SYS_TimerStarted(&task));
+}
+
+// Many timers in a few slots, restarted in a scrambled order, all fire on time
+static void testManyTimers(void)
+{
+    static SYS_Timer_t timers[40];
+
+    setup();
+    for (uint8_t i = 0; i < 40; i++)
+    {
+        timerInit(&timers[i], 1 + ((i * 37) % 200), SYS_TIMER_INTERVAL_MODE);
+        SYS_TimerStart(&timers[i]);
+    }
+    for (uint8_t i = 0; i < 40; i += 3)
+    {
+        SYS_TimerRestart(&timers[i]);
+    }
+    CHECK(SYS_TimerCheck());
+
+    run(200);
+
+    CHECK_EQ(firedCount, 40);
+    for (uint8_t i = 0; i < firedCount; i++)
+    {
+        CHECK_EQ(fired[i].timeMs, fired[i].timer->interval);
+        if (i)
+        {
+            CHECK(fired[i - 1].timeMs <= fired[i].timeMs);
+        }
+    }
+}
+
+#define DAY_MS          86400000ul
+#define DAY_PERIOD_MS   500
+#define DAY_STALL_MS    1200
+
+static uint32_t gridNext;       // Deadline the grid timer fires for next
+static uint32_t gridLast;
+static uint32_t gridFired;
+static uint32_t gridMisses;     // Fires off the interval grid or before their deadline
+
+static void gridHandler(SYS_Timer_t *timer)
+{
+    if ((gridNext % DAY_PERIOD_MS) || ((int32_t)(SYS_Timer_Time() - gridNext) < 0))
+    {
+        gridMisses++;
+    }
+    gridLast = gridNext;
+    gridNext = timer->expires;
+    gridFired++;
+}
+
+// A periodic timer over a day of ticks, with the main loop stalling 1.2 s at random,
+// has no cumulative drift: every deadline on its grid is either fired or skipped
+static void testPeriodicDay(void)
+{
+    SYS_Timer_t periodic;
+    SYS_TimerStats_t stats;
+    uint32_t stallUntil = 0;
+    uint32_t now;
+
+    setup();
+    timerInit(&periodic, DAY_PERIOD_MS, SYS_TIMER_PERIODIC_MODE);
+    periodic.handler = gridHandler;
+    SYS_TimerStart(&periodic);
+    gridNext   = periodic.expires;
+    gridLast   = 0;
+    gridFired  = 0;
+    gridMisses = 0;
+
+    while ((now = SYS_Timer_Time()) < DAY_MS)
+    {
+        // The last deadline isn't stalled over, so the day ends on a fire
+        if ((now >= stallUntil) && (now + DAY_STALL_MS < DAY_MS - DAY_PERIOD_MS) && (0 == testRandom() % 2000))
+        {
+            stallUntil = now + DAY_STALL_MS;
+        }
+
+        SYS_HwExpiry_Cb(1);
+        if (now + 1 >= stallUntil)
+        {
+            SYS_TimerTaskHandler();
+        }
+    }
+
+    SYS_TimerGetStats(&stats);
+    CHECK(stats.skipped > 0);
+    CHECK_EQ(gridMisses, 0);
+    CHECK_EQ(gridLast, DAY_MS);
+    CHECK_EQ(gridFired + stats.skipped, DAY_MS / DAY_PERIOD_MS);
+    CHECK_EQ(periodic.expires, DAY_MS + DAY_PERIOD_MS);
+    CHECK(SYS_TimerCheck());
+}
+
+#ifdef HW_TIMER_TICKLESS
+// Forget the wakeups asked of the hw timer so far
+static void hwRequestsClear(void)
+{
+    stubHwRequestMs = UINT32_MAX;
+    stubHwRequests  = 0;
+}
+
+// Brute force next wakeup over the given timers, UINT32_MAX if none is started
+static uint32_t scanNextExpiry(SYS_Timer_t *timers, uint8_t count)
+{
+    uint32_t now = SYS_Timer_Time();
+    uint32_t next = UINT32_MAX;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (SYS_TimerStarted(&timers[i]) && (timers[i].expires + timers[i].slack - now < next))
+        {
+            next = timers[i].expires + timers[i].slack - now;
+        }
+    }
+    return next;
+}
+
+// The cached next deadline matches a full scan through random start, stop,
+// restart and expiry
+static void testNextExpiry(void)
+{
+    static SYS_Timer_t timers[32];
+
+    setup();
+    for (uint8_t i = 0; i < 32; i++)
+    {
+        timerInit(&timers[i], 1 + (testRandom() % 300), (i & 1) ? SYS_TIMER_PERIODIC_MODE : SYS_TIMER_INTERVAL_MODE);
+        timers[i].slack = (i % 3) ? 0 : testRandom() % 100;
+    }
+
+    for (uint16_t step = 0; step < 5000; step++)
+    {
+        SYS_Timer_t *timer = &timers[testRandom() % 32];
+        bool placed = false;
+
+        hwRequestsClear();
+        switch (testRandom() % 4)
+        {
+            case 0:
+                placed = !SYS_TimerStarted(timer);
+                SYS_TimerStart(timer);
+                break;
+            case 1:
+                SYS_TimerStop(timer);
+                break;
+            case 2:
+                timer->interval = 1 + (testRandom() % 300);
+                SYS_TimerRestart(timer);
+                placed = true;
+                break;
+            default:
+                run(1 + (testRandom() % 20));
+                hwRequestsClear();
+                break;
+        }
+
+        // Each placement asks the hw timer for its own wakeup, nothing else does
+        CHECK_EQ(stubHwRequests, placed ? 1 : 0);
+        if (placed)
+        {
+            CHECK_EQ(stubHwRequestMs, timer->expires + timer->slack - SYS_Timer_Time());
+        }
+
+        firedCount = 0;
+        CHECK_EQ(SYS_TimerNextExpiry(), scanNextExpiry(timers, 32));
+        CHECK(SYS_TimerCheck());
+        if (testFailures)
+        {
+            break;
+        }
+    }
+}
+
+// A timer with slack waits for a later deadline inside its slack, and both run
+// on the one wakeup
+static void testSlackCoalescing(void)
+{
+    SYS_Timer_t lazy;
+    SYS_Timer_t strict;
+
+    setup();
+    timerInit(&lazy, 10, SYS_TIMER_INTERVAL_MODE);
+    lazy.slack = 20;
+    timerInit(&strict, 25, SYS_TIMER_INTERVAL_MODE);
+    hwRequestsClear();
+    SYS_TimerStart(&lazy);
+    CHECK_EQ(SYS_TimerNextExpiry(), 30);
+    CHECK_EQ(stubHwRequestMs, 30);
+    SYS_TimerStart(&strict);
+    CHECK_EQ(SYS_TimerNextExpiry(), 25);
+    CHECK_EQ(stubHwRequestMs, 25);
+    CHECK_EQ(stubHwRequests, 2);
+
+    // The wakeup the hw timer would take, all 25 ms in one go. The group needs no
+    // request of its own.
+    hwRequestsClear();
+    SYS_HwExpiry_Cb(25);
+    SYS_TimerTaskHandler();
+
+    CHECK_EQ(stubHwRequests, 0);
+    CHECK_EQ(firedCount, 2);
+    CHECK(fired[0].timer == &lazy);
+    CHECK(fired[1].timer == &strict);
+    CHECK_EQ(SYS_TimerNextExpiry(), UINT32_MAX);
+
+    // Outside the slack the lazy timer still sets the wakeup
+    lazy.slack = 5;
+    hwRequestsClear();
+    SYS_TimerStart(&lazy);
+    SYS_TimerStart(&strict);
+    CHECK_EQ(SYS_TimerNextExpiry(), 15);
+    CHECK_EQ(stubHwRequestMs, 15);
+    CHECK_EQ(stubHwRequests, 2);
+    CHECK(SYS_TimerCheck());
+}
+
+// More started timers than the heap holds falls back to a wakeup every tick
+static void testHeapOverflow(void)
+{
+    static SYS_Timer_t timers[SYS_TIMER_HEAP_SIZE + 2];
+
+    setup();
+    for (uint8_t i = 0; i < SYS_TIMER_HEAP_SIZE + 2; i++)
+    {
+        timerInit(&timers[i], 100 + i, SYS_TIMER_INTERVAL_MODE);
+        SYS_TimerStart(&timers[i]);
+    }
+    CHECK_EQ(SYS_TimerNextExpiry(), HW_TIMER_INTERVAL);
+
+    // The timers that missed the heap still asked for their wakeup
+    CHECK_EQ(stubHwRequests, SYS_TIMER_HEAP_SIZE + 2);
+    CHECK_EQ(stubHwRequestMs, 100);
+
+    SYS_TimerStop(&timers[SYS_TIMER_HEAP_SIZE]);
+    SYS_TimerStop(&timers[SYS_TIMER_HEAP_SIZE + 1]);
+    CHECK_EQ(SYS_TimerNextExpiry(), 100);
+
+    run(100);
+    CHECK_EQ(firedCount, 1);
+    CHECK_EQ(SYS_TimerNextExpiry(), 1);
+    CHECK(SYS_TimerCheck());
+}
+#endif
+
+int main(void)
+{
+    TEST_RUN(testSlotOrdering);
+    TEST_RUN(testStopInSlot);
+    TEST_RUN(testPeriodicCadence);
+    TEST_RUN(testPeriodicStall);
+    TEST_RUN(testPeriodicStopInHandler);
+    TEST_RUN(testDomains);
+    TEST_RUN(testManyTimers);
+    TEST_RUN(testPeriodicDay);
+#ifdef HW_TIMER_TICKLESS
+    TEST_RUN(testNextExpiry);
+    TEST_RUN(testSlackCoalescing);
+    TEST_RUN(testHeapOverflow);
+#endif
+
+    return TEST_EXIT();
+}